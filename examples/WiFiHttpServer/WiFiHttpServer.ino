@@ -0,0 +1,100 @@
+/*
+  WiFi HTTP Server
+
+ A web server that shows the value of the analog input pins, built
+ on the WiFiHttpServer engine. Requests are dispatched through a
+ route table, and browsers can keep the connection open between
+ requests.
+
+ This example is written for a network using WPA encryption. For
+ WEP or WPA, change the WiFi.begin() call accordingly.
+
+ Circuit:
+ * Analog inputs attached to pins A0 through A5 (optional)
+
+ */
+
+#include <SPI.h>
+#include <WiFiNINA.h>
+#include <WiFiHttpServer.h>
+
+#include "arduino_secrets.h"
+///////please enter your sensitive data in the Secret tab/arduino_secrets.h
+char ssid[] = SECRET_SSID;        // your network SSID (name)
+char pass[] = SECRET_PASS;    // your network password (use for WPA, or use as key for WEP)
+
+int status = WL_IDLE_STATUS;
+
+void handleRoot(WiFiHttpRequest& request, WiFiHttpResponse& response);
+void handleAnalog(WiFiHttpRequest& request, WiFiHttpResponse& response);
+
+const WiFiHttpRoute routes[] = {
+  { WIFI_HTTP_GET, "/",        handleRoot },
+  { WIFI_HTTP_GET, "/analog*", handleAnalog },
+};
+
+WiFiServer server(80);
+WiFiHttpServer http(server, routes, sizeof(routes) / sizeof(routes[0]));
+
+void setup() {
+  //Initialize serial and wait for port to open:
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect. Needed for native USB port only
+  }
+
+  // check for the WiFi module:
+  if (WiFi.status() == WL_NO_MODULE) {
+    Serial.println("Communication with WiFi module failed!");
+    // don't continue
+    while (true);
+  }
+
+  String fv = WiFi.firmwareVersion();
+  if (fv < WIFI_FIRMWARE_LATEST_VERSION) {
+    Serial.println("Please upgrade the firmware");
+  }
+
+  // attempt to connect to WiFi network:
+  while (status != WL_CONNECTED) {
+    Serial.print("Attempting to connect to SSID: ");
+    Serial.println(ssid);
+    // Connect to WPA/WPA2 network. Change this line if using open or WEP network:
+    status = WiFi.begin(ssid, pass);
+
+    // wait 10 seconds for connection:
+    delay(10000);
+  }
+  http.begin();
+
+  Serial.print("HTTP server address: ");
+  Serial.println(WiFi.localIP());
+}
+
+void loop() {
+  // serve the connected clients, without blocking
+  http.poll();
+}
+
+void handleRoot(WiFiHttpRequest& request, WiFiHttpResponse& response) {
+  // the length is unknown, so the body is sent with chunked encoding
+  response.begin(200, "text/html");
+  response.println("<!DOCTYPE HTML>");
+  response.println("<html>");
+  for (int analogChannel = 0; analogChannel < 6; analogChannel++) {
+    response.print("analog input ");
+    response.print(analogChannel);
+    response.print(" is ");
+    response.print(analogRead(analogChannel));
+    response.println("<br />");
+  }
+  response.println("</html>");
+}
+
+void handleAnalog(WiFiHttpRequest& request, WiFiHttpResponse& response) {
+  // for example /analog?2
+  int analogChannel = atoi(request.query());
+
+  response.begin(200, "text/plain");
+  response.println(analogRead(analogChannel));
+}
@@ -0,0 +1,109 @@
+/*
+ WiFi SNTP Client
+
+ Keeps the time synchronized with several NTP servers using the
+ WiFiSntpClient engine, and prints the UTC time with milliseconds
+ every second. The network round trip is compensated, and the clock
+ is corrected gradually so that it never goes backward.
+
+ This example is written for a network using WPA encryption. For
+ WEP or WPA, change the WiFi.begin() call accordingly.
+
+ Circuit:
+  * Board with NINA module (Arduino MKR WiFi 1010, MKR VIDOR 4000 and UNO WiFi Rev.2)
+
+ */
+
+#include <SPI.h>
+#include <WiFiNINA.h>
+#include <WiFiSntpClient.h>
+
+#include "arduino_secrets.h"
+///////please enter your sensitive data in the Secret tab/arduino_secrets.h
+char ssid[] = SECRET_SSID;        // your network SSID (name)
+char pass[] = SECRET_PASS;    // your network password (use for WPA, or use as key for WEP)
+
+int status = WL_IDLE_STATUS;
+
+WiFiUDP Udp;
+WiFiSntpClient sntp(Udp);
+
+unsigned long lastPrint = 0;
+
+void setup() {
+  //Initialize serial and wait for port to open:
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect. Needed for native USB port only
+  }
+
+  // check for the WiFi module:
+  if (WiFi.status() == WL_NO_MODULE) {
+    Serial.println("Communication with WiFi module failed!");
+    // don't continue
+    while (true);
+  }
+
+  String fv = WiFi.firmwareVersion();
+  if (fv < WIFI_FIRMWARE_LATEST_VERSION) {
+    Serial.println("Please upgrade the firmware");
+  }
+
+  // attempt to connect to WiFi network:
+  while (status != WL_CONNECTED) {
+    Serial.print("Attempting to connect to SSID: ");
+    Serial.println(ssid);
+    // Connect to WPA/WPA2 network. Change this line if using open or WEP network:
+    status = WiFi.begin(ssid, pass);
+
+    // wait 10 seconds for connection:
+    delay(10000);
+  }
+  Serial.println("Connected to WiFi");
+
+  // the reply with the shortest round trip among the servers is used
+  sntp.addServer("0.pool.ntp.org");
+  sntp.addServer("1.pool.ntp.org");
+  sntp.addServer("time.nist.gov");
+  // synchronize again every 10 minutes
+  sntp.setInterval(600);
+  sntp.begin();
+}
+
+void loop() {
+  // send the requests and handle the replies, without blocking
+  sntp.poll();
+
+  if (sntp.isSynchronized() && millis() - lastPrint >= 1000) {
+    lastPrint = millis();
+
+    // read the time once, so that the seconds and milliseconds match
+    uint64_t now = sntp.getEpochMicros();
+    unsigned long epoch = now / 1000000;
+    unsigned long ms = (now % 1000000) / 1000;
+
+    // print the hour, minute, second and millisecond
+    Serial.print("The UTC time is ");
+    print2Digits((epoch % 86400L) / 3600);
+    Serial.print(':');
+    print2Digits((epoch % 3600) / 60);
+    Serial.print(':');
+    print2Digits(epoch % 60);
+    Serial.print('.');
+    if (ms < 100) {
+      Serial.print('0');
+    }
+    print2Digits(ms);
+
+    Serial.print("  (round trip ");
+    Serial.print(sntp.lastDelay());
+    Serial.println(" us)");
+  }
+}
+
+void print2Digits(unsigned long number) {
+  if (number < 10) {
+    Serial.print('0');
+  }
+  Serial.print(number);
+}
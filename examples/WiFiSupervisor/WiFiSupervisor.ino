@@ -0,0 +1,110 @@
+/*
+ WiFi Supervisor
+
+ A simple web server that stays reachable across access point outages.
+ The WiFiSupervisor connects the board, notices when the connection is
+ lost, and connects again, waiting longer after every failed attempt.
+ The supervisor starts the web server once connected, and again after
+ each reconnection. The page shows how long the board has been
+ connected and how many times it had to reconnect.
+
+ This example is written for a network using WPA encryption. For
+ an open network, leave the password out of the WiFiSupervisor.
+
+ Circuit:
+  * Board with NINA module (Arduino MKR WiFi 1010, MKR VIDOR 4000 and UNO WiFi Rev.2)
+
+ */
+
+#include <SPI.h>
+#include <WiFiNINA.h>
+#include <WiFiSupervisor.h>
+
+#include "arduino_secrets.h"
+///////please enter your sensitive data in the Secret tab/arduino_secrets.h
+char ssid[] = SECRET_SSID;        // your network SSID (name)
+char pass[] = SECRET_PASS;    // your network password (use for WPA, or use as key for WEP)
+
+WiFiServer server(80);
+WiFiSupervisor supervisor(ssid, pass);
+
+bool wasConnected = false;
+
+void setup() {
+  //Initialize serial and wait for port to open:
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect. Needed for native USB port only
+  }
+
+  // check for the WiFi module:
+  if (WiFi.status() == WL_NO_MODULE) {
+    Serial.println("Communication with WiFi module failed!");
+    // don't continue
+    while (true);
+  }
+
+  String fv = WiFi.firmwareVersion();
+  if (fv < WIFI_FIRMWARE_LATEST_VERSION) {
+    Serial.println("Please upgrade the firmware");
+  }
+
+  // wait between 5 seconds and 5 minutes between two connection attempts
+  supervisor.setBackoff(5000, 300000);
+  supervisor.addServer(server);
+
+  Serial.print("Attempting to connect to SSID: ");
+  Serial.println(ssid);
+  supervisor.begin();
+}
+
+void loop() {
+  // follow the connection, without blocking
+  supervisor.poll();
+
+  if (supervisor.connected() != wasConnected) {
+    wasConnected = supervisor.connected();
+    if (wasConnected) {
+      // the supervisor has started the server
+      Serial.print("Connected, IP Address: ");
+      Serial.println(WiFi.localIP());
+    } else {
+      Serial.println("Connection lost, reconnecting");
+    }
+  }
+
+  if (!wasConnected) {
+    return;
+  }
+
+  WiFiClient client = server.available();
+  if (client) {
+    // an HTTP request ends with a blank line
+    bool currentLineIsBlank = true;
+    while (client.connected()) {
+      if (client.available()) {
+        char c = client.read();
+        if (c == '\n' && currentLineIsBlank) {
+          client.println("HTTP/1.1 200 OK");
+          client.println("Content-Type: text/plain");
+          client.println("Connection: close");
+          client.println();
+          client.print("Connected for ");
+          client.print(supervisor.uptime() / 1000);
+          client.println(" seconds");
+          client.print("Reconnections: ");
+          client.println(supervisor.reconnects());
+          break;
+        }
+        if (c == '\n') {
+          currentLineIsBlank = true;
+        } else if (c != '\r') {
+          currentLineIsBlank = false;
+        }
+      }
+    }
+    // give the web browser time to receive the data
+    delay(1);
+    client.stop();
+  }
+}
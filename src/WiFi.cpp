@@ -18,8 +18,13 @@
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+#include <string.h>
+
 #include "utility/wifi_drv.h"
+#include "utility/WiFiDnsCache.h"
+#include "utility/WiFiSocketBuffer.h"
 #include "WiFi.h"
+#include "WiFiPreferences.h"
 
 extern "C" {
   #include "utility/wl_definitions.h"
@@ -27,8 +32,159 @@ extern "C" {
   //#include "utility/debug.h"
 }
 
-WiFiClass::WiFiClass() : _timeout(50000), _feed_watchdog_func(0)
+WiFiClass::WiFiClass() :
+  _timeout(50000),
+  _feed_watchdog_func(0),
+  _scanning(false),
+  _scanResult(WIFI_SCAN_FAILED),
+  _scanStart(0),
+  _scanCallback(0),
+  _scanCount(0),
+  _scanFiltered(false),
+  _linkState(LINK_IDLE),
+  _linkStart(0),
+  _linkChecked(0),
+  _onConnected(0),
+  _onDisconnected(0),
+  _onFailed(0),
+  _hostname(0),
+  _lowPowerMode(false)
+{
+}
+
+// the module is still looking for the network or waiting for the association
+static bool isConnecting(uint8_t status)
+{
+    return (status == WL_IDLE_STATUS) || (status == WL_NO_SSID_AVAIL) || (status == WL_SCAN_COMPLETED);
+}
+
+// connected to a network, or access point started
+static bool isLinkUp(uint8_t status)
 {
+    return (status == WL_CONNECTED) || (status == WL_AP_LISTENING) || (status == WL_AP_CONNECTED);
+}
+
+uint8_t WiFiClass::waitForConnection()
+{
+    uint8_t status = WL_IDLE_STATUS;
+
+    for (unsigned long start = millis(); (millis() - start) < _timeout;)
+    {
+        feedWatchdog();
+        delay(WL_DELAY_START_CONNECTION);
+        status = WiFiDrv::getConnectionStatus();
+        if (!isConnecting(status)) {
+            break;
+        }
+    }
+
+    // let poll() report the loss of the connection
+    _linkState = isLinkUp(status) ? LINK_CONNECTED : LINK_IDLE;
+    _linkChecked = millis();
+    return status;
+}
+
+void WiFiClass::startLink()
+{
+    _linkState = LINK_CONNECTING;
+    _linkStart = _linkChecked = millis();
+}
+
+int WiFiClass::beginAsync(const char* ssid)
+{
+    if (WiFiDrv::wifiSetNetwork(ssid, strlen(ssid)) == WL_FAILURE) {
+        return WL_CONNECT_FAILED;
+    }
+
+    startLink();
+    return WL_IDLE_STATUS;
+}
+
+int WiFiClass::beginAsync(const char* ssid, const char *passphrase)
+{
+    if (WiFiDrv::wifiSetPassphrase(ssid, strlen(ssid), passphrase, strlen(passphrase)) == WL_FAILURE) {
+        return WL_CONNECT_FAILED;
+    }
+
+    startLink();
+    return WL_IDLE_STATUS;
+}
+
+int WiFiClass::beginAPAsync(const char *ssid, uint8_t channel)
+{
+    if (WiFiDrv::wifiSetApNetwork(ssid, strlen(ssid), channel) == WL_FAILURE) {
+        return WL_AP_FAILED;
+    }
+
+    startLink();
+    return WL_IDLE_STATUS;
+}
+
+int WiFiClass::beginAPAsync(const char *ssid, const char* passphrase, uint8_t channel)
+{
+    if (WiFiDrv::wifiSetApPassphrase(ssid, strlen(ssid), passphrase, strlen(passphrase), channel) == WL_FAILURE) {
+        return WL_AP_FAILED;
+    }
+
+    startLink();
+    return WL_IDLE_STATUS;
+}
+
+int WiFiClass::beginEnterpriseAsync(const char* ssid, const char* username, const char* password, const char* identity, const char* ca)
+{
+    if (WiFiDrv::wifiSetEnterprise(0 /*PEAP/MSCHAPv2*/, ssid, strlen(ssid), username, strlen(username), password, strlen(password), identity, strlen(identity), ca, strlen(ca) + 1) == WL_FAILURE) {
+        return WL_CONNECT_FAILED;
+    }
+
+    startLink();
+    return WL_IDLE_STATUS;
+}
+
+void WiFiClass::onConnected(WiFiEventCallback callback)
+{
+    _onConnected = callback;
+}
+
+void WiFiClass::onFailed(WiFiEventCallback callback)
+{
+    _onFailed = callback;
+}
+
+void WiFiClass::onDisconnected(WiFiEventCallback callback)
+{
+    _onDisconnected = callback;
+}
+
+void WiFiClass::pollLink()
+{
+    unsigned long interval = (_linkState == LINK_CONNECTING) ? WL_DELAY_START_CONNECTION : WIFI_LINK_CHECK_INTERVAL;
+
+    if (_linkState == LINK_IDLE || millis() - _linkChecked < interval) {
+        return;
+    }
+
+    _linkChecked = millis();
+
+    uint8_t status = WiFiDrv::getConnectionStatus();
+
+    if (_linkState == LINK_CONNECTED) {
+        if (!isLinkUp(status)) {
+            _linkState = LINK_IDLE;
+            if (_onDisconnected) {
+                _onDisconnected(status);
+            }
+        }
+    } else if (isLinkUp(status)) {
+        _linkState = LINK_CONNECTED;
+        if (_onConnected) {
+            _onConnected(status);
+        }
+    } else if (!isConnecting(status) || millis() - _linkStart >= _timeout) {
+        _linkState = LINK_IDLE;
+        if (_onFailed) {
+            _onFailed(status);
+        }
+    }
 }
 
 void WiFiClass::init()
@@ -52,15 +208,7 @@ int WiFiClass::begin(const char* ssid)
 
     if (WiFiDrv::wifiSetNetwork(ssid, strlen(ssid)) != WL_FAILURE)
     {
-        for (unsigned long start = millis(); (millis() - start) < _timeout;)
-        {
-            feedWatchdog();
-            delay(WL_DELAY_START_CONNECTION);
-            status = WiFiDrv::getConnectionStatus();
-            if ((status != WL_IDLE_STATUS) && (status != WL_NO_SSID_AVAIL) && (status != WL_SCAN_COMPLETED)) {
-                break;
-            }
-        }
+        status = waitForConnection();
     }else
     {
         status = WL_CONNECT_FAILED;
@@ -75,15 +223,7 @@ int WiFiClass::begin(const char* ssid, uint8_t key_idx, const char *key)
     // set encryption key
     if (WiFiDrv::wifiSetKey(ssid, strlen(ssid), key_idx, key, strlen(key)) != WL_FAILURE)
     {
-        for (unsigned long start = millis(); (millis() - start) < _timeout;)
-        {
-            feedWatchdog();
-            delay(WL_DELAY_START_CONNECTION);
-            status = WiFiDrv::getConnectionStatus();
-            if ((status != WL_IDLE_STATUS) && (status != WL_NO_SSID_AVAIL) && (status != WL_SCAN_COMPLETED)) {
-                break;
-            }
-        }
+        status = waitForConnection();
     }else{
         status = WL_CONNECT_FAILED;
     }
@@ -97,21 +237,132 @@ int WiFiClass::begin(const char* ssid, const char *passphrase)
     // set passphrase
     if (WiFiDrv::wifiSetPassphrase(ssid, strlen(ssid), passphrase, strlen(passphrase))!= WL_FAILURE)
     {
-        for (unsigned long start = millis(); (millis() - start) < _timeout;)
-        {
-            feedWatchdog();
-            delay(WL_DELAY_START_CONNECTION);
-            status = WiFiDrv::getConnectionStatus();
-            if ((status != WL_IDLE_STATUS) && (status != WL_NO_SSID_AVAIL) && (status != WL_SCAN_COMPLETED)) {
-                break;
-            }
-        }
+        status = waitForConnection();
     }else{
         status = WL_CONNECT_FAILED;
     }
     return status;
 }
 
+#define FAST_CONNECT_NAMESPACE "wifinina"
+#define FAST_CONNECT_KEY "fastconnect"
+#define FAST_CONNECT_VERSION 2
+
+struct FastConnectRecord {
+    uint8_t version;
+    char ssid[WL_SSID_MAX_LENGTH + 1];
+    uint8_t bssid[WL_MAC_ADDR_LENGTH];
+    uint32_t localIp;
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+    // time the settings were obtained from DHCP, 0 when the module didn't know it
+    uint32_t obtained;
+    // connections made with the settings since then
+    uint8_t joins;
+};
+
+static void saveFastConnect(const FastConnectRecord& record)
+{
+    Preferences prefs;
+
+    if (prefs.begin(FAST_CONNECT_NAMESPACE)) {
+        prefs.putBytes(FAST_CONNECT_KEY, &record, sizeof(record));
+        prefs.end();
+    }
+}
+
+int WiFiClass::beginFast(const char* ssid, const char *passphrase, bool checkGateway)
+{
+    FastConnectRecord record;
+    Preferences prefs;
+    bool cached = false;
+    uint8_t status;
+
+    if (prefs.begin(FAST_CONNECT_NAMESPACE, true)) {
+        cached = (prefs.getBytes(FAST_CONNECT_KEY, &record, sizeof(record)) == sizeof(record)) &&
+                 record.version == FAST_CONNECT_VERSION &&
+                 strncmp(record.ssid, ssid, WL_SSID_MAX_LENGTH) == 0 &&
+                 record.joins < WIFI_FAST_CONNECT_MAX_JOINS;
+        prefs.end();
+    }
+
+    if (cached) {
+        config(record.localIp, record.dns, record.gateway, record.subnet);
+        status = begin(ssid, passphrase);
+        if (status != WL_CONNECTED) {
+            // the network wasn't joined, the saved settings aren't at fault
+            return status;
+        }
+
+        uint8_t bssid[WL_MAC_ADDR_LENGTH];
+        unsigned long now = getTime();
+
+        // another access point may serve another subnet, don't trust the settings
+        bool valid = (memcmp(BSSID(bssid), record.bssid, WL_MAC_ADDR_LENGTH) == 0);
+
+        // the lease length isn't known, don't keep the address longer than
+        // WIFI_FAST_CONNECT_MAX_AGE once the module knows the time
+        if (valid && record.obtained && now && (now - record.obtained) >= WIFI_FAST_CONNECT_MAX_AGE) {
+            valid = false;
+        }
+
+        // the gateway answers only if the settings still fit the network
+        if (valid && checkGateway && ping(IPAddress(record.gateway)) < 0) {
+            valid = false;
+        }
+
+        if (valid) {
+            record.joins++;
+            saveFastConnect(record);
+            return status;
+        }
+
+        // the module keeps a static configuration until it is reset
+        WiFiDrv::wifiDriverInit();
+
+        // the sockets were lost with the reset, forget them
+        for (uint8_t sock = 0; sock < WIFI_MAX_SOCK_NUM; sock++) {
+            WiFiSocketBuffer.close(sock);
+        }
+        if (_hostname) {
+            WiFiDrv::setHostname(_hostname);
+        }
+        if (_lowPowerMode) {
+            WiFiDrv::setPowerMode(1);
+        }
+    }
+
+    status = begin(ssid, passphrase);
+    if (status != WL_CONNECTED) {
+        return status;
+    }
+
+    memset(&record, 0, sizeof(record));
+    record.version = FAST_CONNECT_VERSION;
+    strncpy(record.ssid, ssid, WL_SSID_MAX_LENGTH);
+    BSSID(record.bssid);
+    record.localIp = localIP();
+    record.gateway = gatewayIP();
+    record.subnet = subnetMask();
+    record.dns = dnsIP();
+    record.obtained = getTime();
+    record.joins = 0;
+
+    saveFastConnect(record);
+    return status;
+}
+
+void WiFiClass::clearFastConnect()
+{
+    Preferences prefs;
+
+    if (prefs.begin(FAST_CONNECT_NAMESPACE)) {
+        prefs.remove(FAST_CONNECT_KEY);
+        prefs.end();
+    }
+}
+
 uint8_t WiFiClass::beginAP(const char *ssid)
 {
     return beginAP(ssid, 1);
@@ -123,14 +374,7 @@ uint8_t WiFiClass::beginAP(const char *ssid, uint8_t channel)
 
     if (WiFiDrv::wifiSetApNetwork(ssid, strlen(ssid), channel) != WL_FAILURE)
     {
-        for (unsigned long start = millis(); (millis() - start) < _timeout;)
-        {
-            delay(WL_DELAY_START_CONNECTION);
-            status = WiFiDrv::getConnectionStatus();
-            if ((status != WL_IDLE_STATUS) && (status != WL_NO_SSID_AVAIL) && (status != WL_SCAN_COMPLETED)) {
-                break;
-            }
-        }
+        status = waitForConnection();
     }else{
         status = WL_AP_FAILED;
     }
@@ -149,14 +393,7 @@ uint8_t WiFiClass::beginAP(const char *ssid, const char* passphrase, uint8_t cha
     // set passphrase
     if (WiFiDrv::wifiSetApPassphrase(ssid, strlen(ssid), passphrase, strlen(passphrase), channel)!= WL_FAILURE)
     {
-        for (unsigned long start = millis(); (millis() - start) < _timeout;)
-        {
-            delay(WL_DELAY_START_CONNECTION);
-            status = WiFiDrv::getConnectionStatus();
-            if ((status != WL_IDLE_STATUS) && (status != WL_NO_SSID_AVAIL) && (status != WL_SCAN_COMPLETED)) {
-                break;
-            }
-        }
+        status = waitForConnection();
     }else{
         status = WL_AP_FAILED;
     }
@@ -180,14 +417,7 @@ uint8_t WiFiClass::beginEnterprise(const char* ssid, const char* username, const
     // set passphrase
     if (WiFiDrv::wifiSetEnterprise(0 /*PEAP/MSCHAPv2*/, ssid, strlen(ssid), username, strlen(username), password, strlen(password), identity, strlen(identity), ca, strlen(ca) + 1)!= WL_FAILURE)
     {
-        for (unsigned long start = millis(); (millis() - start) < _timeout;)
-        {
-            delay(WL_DELAY_START_CONNECTION);
-            status = WiFiDrv::getConnectionStatus();
-            if ((status != WL_IDLE_STATUS) && (status != WL_NO_SSID_AVAIL) && (status != WL_SCAN_COMPLETED)) {
-                break;
-            }
-        }
+        status = waitForConnection();
     } else {
         status = WL_CONNECT_FAILED;
     }
@@ -236,16 +466,19 @@ void WiFiClass::setDNS(IPAddress dns_server1, IPAddress dns_server2)
 
 void WiFiClass::setHostname(const char* name)
 {
+    _hostname = name;
     WiFiDrv::setHostname(name);
 }
 
 int WiFiClass::disconnect()
 {
+    _linkState = LINK_IDLE;
     return WiFiDrv::disconnect();
 }
 
 void WiFiClass::end(void)
 {
+    _linkState = LINK_IDLE;
     WiFiDrv::wifiDriverDeinit();
 }
 
@@ -321,32 +554,155 @@ int8_t WiFiClass::scanNetworks()
         delay(2000);
         numOfNetworks = WiFiDrv::getScanNetworks();
     }while (( numOfNetworks == 0)&&(--attempts>0));
+    _scanFiltered = false;
+    _scanCount = numOfNetworks;
     return numOfNetworks;
 }
 
+int8_t WiFiClass::startScan()
+{
+    WiFiScanFilter filter = { 0, NULL };
+
+    return startScan(filter);
+}
+
+int8_t WiFiClass::startScan(const WiFiScanFilter& filter)
+{
+    _scanFilter = filter;
+    _scanFiltered = false;
+    _scanCount = 0;
+
+    if (WiFiDrv::startScanNetworks() == WL_FAILURE) {
+        _scanning = false;
+        _scanResult = WIFI_SCAN_FAILED;
+        return WL_FAILURE;
+    }
+
+    _scanning = true;
+    _scanResult = WIFI_SCAN_RUNNING;
+    _scanStart = millis();
+    return WL_SUCCESS;
+}
+
+int8_t WiFiClass::scanComplete()
+{
+    if (!_scanning || millis() - _scanStart < WIFI_SCAN_DELAY) {
+        return _scanResult;
+    }
+
+    // the module runs the scan before answering, asking again would only
+    // start another one
+    uint8_t numOfNetworks = WiFiDrv::getScanNetworks();
+    _scanning = false;
+    _scanResult = filterScan(numOfNetworks);
+    return _scanResult;
+}
+
+uint8_t WiFiClass::filterScan(uint8_t numOfNetworks)
+{
+    _scanFiltered = (_scanFilter.channelMask != 0 || _scanFilter.ssid != NULL);
+    _scanCount = 0;
+
+    if (!_scanFiltered) {
+        _scanCount = numOfNetworks;
+        return _scanCount;
+    }
+
+    for (uint8_t i = 0; i < numOfNetworks && i < WL_NETWORKS_LIST_MAXNUM; i++) {
+        // the SSIDs are already here, check them before asking for the channel
+        if (_scanFilter.ssid) {
+            const char* ssid = WiFiDrv::getSSIDNetoworks(i);
+
+            if (ssid == NULL || strncmp(ssid, _scanFilter.ssid, WL_SSID_MAX_LENGTH) != 0) {
+                continue;
+            }
+        }
+        if (_scanFilter.channelMask) {
+            uint8_t channel = WiFiDrv::getChannelNetowrks(i);
+
+            if (channel > 15 || !(_scanFilter.channelMask & (1 << channel))) {
+                continue;
+            }
+        }
+        _scanIndex[_scanCount++] = i;
+    }
+    return _scanCount;
+}
+
+uint8_t WiFiClass::networkIndex(uint8_t networkItem)
+{
+    if (_scanFiltered) {
+        // past the networks kept, give an index the driver rejects
+        return (networkItem < _scanCount) ? _scanIndex[networkItem] : WL_NETWORKS_LIST_MAXNUM;
+    }
+    return networkItem;
+}
+
+void WiFiClass::onScanComplete(WiFiScanCallback callback)
+{
+    _scanCallback = callback;
+}
+
+uint8_t WiFiClass::scanResults(WiFiScanResult results[], uint8_t max)
+{
+    uint8_t count = _scanCount;
+
+    if (count > max) {
+        count = max;
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        scanResult(i, results[i]);
+    }
+    return count;
+}
+
+bool WiFiClass::scanResult(uint8_t networkItem, WiFiScanResult& result)
+{
+    if (networkItem >= _scanCount) {
+        return false;
+    }
+
+    networkItem = networkIndex(networkItem);
+
+    // the SSIDs come with the scan, the rest needs a request per field
+    const char* ssid = WiFiDrv::getSSIDNetoworks(networkItem);
+
+    memset(result.ssid, 0, sizeof(result.ssid));
+    if (ssid) {
+        strncpy(result.ssid, ssid, WL_SSID_MAX_LENGTH);
+    }
+    result.rssi = WiFiDrv::getRSSINetoworks(networkItem);
+    result.encryptionType = WiFiDrv::getEncTypeNetowrks(networkItem);
+    WiFiDrv::getBSSIDNetowrks(networkItem, result.bssid);
+    result.channel = WiFiDrv::getChannelNetowrks(networkItem);
+    result.generation = 0;
+    return true;
+}
+
 const char* WiFiClass::SSID(uint8_t networkItem)
 {
-    return WiFiDrv::getSSIDNetoworks(networkItem);
+    return WiFiDrv::getSSIDNetoworks(networkIndex(networkItem));
 }
 
 int32_t WiFiClass::RSSI(uint8_t networkItem)
 {
-    return WiFiDrv::getRSSINetoworks(networkItem);
+    return WiFiDrv::getRSSINetoworks(networkIndex(networkItem));
 }
 
 uint8_t WiFiClass::encryptionType(uint8_t networkItem)
 {
-    return WiFiDrv::getEncTypeNetowrks(networkItem);
+    return WiFiDrv::getEncTypeNetowrks(networkIndex(networkItem));
 }
 
 uint8_t* WiFiClass::BSSID(uint8_t networkItem, uint8_t* bssid)
 {
-    return WiFiDrv::getBSSIDNetowrks(networkItem, bssid);
+    return WiFiDrv::getBSSIDNetowrks(networkIndex(networkItem), bssid);
 }
 
 uint8_t WiFiClass::channel(uint8_t networkItem)
 {
-    return WiFiDrv::getChannelNetowrks(networkItem);
+    return WiFiDrv::getChannelNetowrks(networkIndex(networkItem));
 }
 
 uint8_t WiFiClass::status()
@@ -361,7 +717,93 @@ uint8_t WiFiClass::reasonCode()
 
 int WiFiClass::hostByName(const char* aHostname, IPAddress& aResult)
 {
-    return WiFiDrv::getHostByName(aHostname, aResult);
+    if (!WiFiDnsCache.enabled()) {
+        return WiFiDrv::getHostByName(aHostname, aResult);
+    }
+
+    if (WiFiDnsCache.lookup(aHostname, aResult)) {
+        return 1;
+    }
+
+    int result = WiFiDrv::getHostByName(aHostname, aResult);
+    if (result == 1) {
+        WiFiDnsCache.store(aHostname, aResult);
+    }
+    return result;
+}
+
+bool WiFiClass::setDnsCache(uint8_t entries, unsigned long lifetime)
+{
+    if (entries == 0) {
+        WiFiDnsCache.end();
+        return false;
+    }
+    return WiFiDnsCache.begin(entries, lifetime);
+}
+
+uint32_t WiFiClass::dnsCacheHits()
+{
+    return WiFiDnsCache.hits();
+}
+
+uint32_t WiFiClass::dnsCacheMisses()
+{
+    return WiFiDnsCache.misses();
+}
+
+int WiFiClass::resolveMany(const char* const aHostnames[], IPAddress aResults[], uint8_t count)
+{
+    int resolved = 0;
+
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t first = 0;
+
+        while (first < i && strcasecmp(aHostnames[first], aHostnames[i]) != 0) {
+            first++;
+        }
+
+        if (first < i) {
+            // already looked up earlier in the list
+            aResults[i] = aResults[first];
+        } else if (hostByName(aHostnames[i], aResults[i]) != 1) {
+            aResults[i] = IPAddress(0, 0, 0, 0);
+        }
+
+        if (aResults[i] != IPAddress(0, 0, 0, 0)) {
+            resolved++;
+        }
+        feedWatchdog();
+    }
+    return resolved;
+}
+
+int WiFiClass::resolveDeferred(const char* aHostname, WiFiResolveCallback callback)
+{
+    return WiFiResolver.add(aHostname, callback);
+}
+
+int WiFiClass::resolveResult(int handle, IPAddress& aResult)
+{
+    return WiFiResolver.result(handle, aResult);
+}
+
+void WiFiClass::resolveCancel(int handle)
+{
+    WiFiResolver.cancel(handle);
+}
+
+void WiFiClass::poll()
+{
+    pollLink();
+    WiFiResolver.poll();
+
+    if (_scanning && _scanCallback) {
+        int8_t numOfNetworks = scanComplete();
+
+        if (numOfNetworks != WIFI_SCAN_RUNNING) {
+            _scanCallback(numOfNetworks);
+        }
+    }
 }
 
 unsigned long WiFiClass::getTime()
@@ -376,11 +818,13 @@ int WiFiClass::setTime(unsigned long unixTime)
 
 void WiFiClass::lowPowerMode()
 {
+    _lowPowerMode = true;
     WiFiDrv::setPowerMode(1);
 }
 
 void WiFiClass::noLowPowerMode()
 {
+    _lowPowerMode = false;
     WiFiDrv::setPowerMode(0);
 }
 
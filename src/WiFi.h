@@ -24,6 +24,27 @@
 #define WIFI_FIRMWARE_LATEST_VERSION "3.0.1"
 #define WIFI_HAS_FEED_WATCHDOG_FUNC
 
+#ifdef __AVR__
+#define WIFI_DNS_CACHE_DEFAULT_ENTRIES 4
+#else
+#define WIFI_DNS_CACHE_DEFAULT_ENTRIES 8
+#endif
+// Time an address returned by hostByName() is reused, in milliseconds
+#define WIFI_DNS_CACHE_DEFAULT_LIFETIME 300000
+
+// Values returned by scanComplete() while no result is available
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+// Time left to the sketch after startScan() before scanComplete() asks for
+// the result, in milliseconds
+#define WIFI_SCAN_DELAY 500
+// Minimum time between two checks of an established connection by poll(), in milliseconds
+#define WIFI_LINK_CHECK_INTERVAL 1000
+// Age after which beginFast() asks DHCP again instead of reusing the saved settings, in seconds
+#define WIFI_FAST_CONNECT_MAX_AGE 3600
+// Connections beginFast() makes with the same saved settings before asking DHCP again
+#define WIFI_FAST_CONNECT_MAX_JOINS 16
+
 #include <inttypes.h>
 
 extern "C" {
@@ -32,12 +53,43 @@ extern "C" {
 }
 
 #include "IPAddress.h"
+#include "utility/WiFiResolver.h"
 #include "WiFiClient.h"
 #include "WiFiSSLClient.h"
 #include "WiFiServer.h"
 #include "WiFiStorage.h"
 
 typedef void(*FeedHostProcessorWatchdogFuncPointer)();
+typedef void(*WiFiScanCallback)(int8_t numOfNetworks);
+typedef void(*WiFiEventCallback)(uint8_t status);
+
+/*
+ * Filter applied to the results of a scan started with WiFiClass::startScan(filter).
+ * It doesn't change how the module scans, only which networks are reported.
+ *
+ * channelMask: bit n set keeps the networks on channel n, 0 keeps all channels
+ * ssid: SSID of the networks to keep, or NULL for all, must stay valid until
+ *       the scan completes
+ */
+struct WiFiScanFilter {
+  uint16_t channelMask;
+  const char* ssid;
+};
+
+/*
+ * Network discovered by a scan, as returned by WiFiClass::scanResults().
+ * bssid is in the same byte order as returned by WiFiClass::BSSID().
+ * generation is the WiFiScanStore scan the network was last seen in, 0
+ * for results that don't come from a store.
+ */
+struct WiFiScanResult {
+  char ssid[WL_SSID_MAX_LENGTH + 1];
+  int32_t rssi;
+  uint8_t encryptionType;
+  uint8_t bssid[WL_MAC_ADDR_LENGTH];
+  uint8_t channel;
+  uint8_t generation;
+};
 
 class WiFiClass
 {
@@ -46,6 +98,38 @@ private:
     static void init();
     unsigned long _timeout;
     FeedHostProcessorWatchdogFuncPointer _feed_watchdog_func;
+    bool _scanning;
+    int8_t _scanResult;
+    unsigned long _scanStart;
+    WiFiScanCallback _scanCallback;
+    uint8_t _scanCount;
+    bool _scanFiltered;
+    WiFiScanFilter _scanFilter;
+    uint8_t _scanIndex[WL_NETWORKS_LIST_MAXNUM];
+
+    uint8_t filterScan(uint8_t numOfNetworks);
+    uint8_t networkIndex(uint8_t networkItem);
+
+    enum {
+        LINK_IDLE,
+        LINK_CONNECTING,
+        LINK_CONNECTED
+    };
+
+    uint8_t _linkState;
+    unsigned long _linkStart;
+    unsigned long _linkChecked;
+    WiFiEventCallback _onConnected;
+    WiFiEventCallback _onDisconnected;
+    WiFiEventCallback _onFailed;
+
+    // set again after beginFast() resets the module
+    const char* _hostname;
+    bool _lowPowerMode;
+
+    uint8_t waitForConnection();
+    void startLink();
+    void pollLink();
 public:
     WiFiClass();
 
@@ -81,6 +165,69 @@ public:
      */
     int begin(const char* ssid, const char *passphrase);
 
+    /* Start WiFi connection with passphrase, reusing the IP settings of the
+     * last connection to the same network so that DHCP is skipped. They are
+     * kept in the module's Preferences after every connection made this way.
+     * If the network can't be joined, the status is returned as is. Once
+     * joined, the module is reset and a normal connection is made,
+     * refreshing the settings, if the access point found differs from the
+     * one the settings were obtained from, if the gateway doesn't answer a
+     * ping, or once the settings are older than WIFI_FAST_CONNECT_MAX_AGE or
+     * were used for WIFI_FAST_CONNECT_MAX_JOINS connections, since the lease
+     * may have ended. The reset closes all the sockets and drops the DNS
+     * servers and the time given to the module: start servers and set them
+     * after beginFast(). The hostname and the low power mode are set again,
+     * the name given to setHostname() must stay valid.
+     *
+     * param ssid: Pointer to the SSID string.
+     * param passphrase: Passphrase. Valid characters in a passphrase
+     *        must be between ASCII 32-126 (decimal).
+     * param checkGateway: false to skip the ping, for gateways that don't
+     *        answer ICMP requests
+     */
+    int beginFast(const char* ssid, const char *passphrase, bool checkGateway = true);
+
+    /*
+     * Forget the settings saved by beginFast().
+     */
+    void clearFastConnect();
+
+    /* Start WiFi connection like begin(), without waiting for it. poll()
+     * follows the connection and calls onConnected() or onFailed().
+     *
+     * param ssid: Pointer to the SSID string.
+     * param passphrase: Passphrase. Valid characters in a passphrase
+     *        must be between ASCII 32-126 (decimal).
+     *
+     * return: WL_IDLE_STATUS if the connection was started, else WL_CONNECT_FAILED
+     */
+    int beginAsync(const char* ssid);
+    int beginAsync(const char* ssid, const char *passphrase);
+
+    /* Start an access point like beginAP(), without waiting for it.
+     * onConnected() is called once the access point is listening.
+     *
+     * return: WL_IDLE_STATUS if the access point was started, else WL_AP_FAILED
+     */
+    int beginAPAsync(const char *ssid, uint8_t channel = 1);
+    int beginAPAsync(const char *ssid, const char* passphrase, uint8_t channel = 1);
+
+    /* Start a WPA2 Enterprise connection like beginEnterprise(), without
+     * waiting for it.
+     *
+     * return: WL_IDLE_STATUS if the connection was started, else WL_CONNECT_FAILED
+     */
+    int beginEnterpriseAsync(const char* ssid, const char* username, const char* password, const char* identity = "", const char* ca = "");
+
+    /*
+     * Set the functions called from poll() with the connection status when
+     * a connection or access point started by one of the Async functions
+     * succeeds or fails, and when an established connection is lost.
+     */
+    void onConnected(WiFiEventCallback callback);
+    void onFailed(WiFiEventCallback callback);
+    void onDisconnected(WiFiEventCallback callback);
+
     uint8_t beginAP(const char *ssid);
     uint8_t beginAP(const char *ssid, uint8_t channel);
     uint8_t beginAP(const char *ssid, const char* passphrase);
@@ -224,6 +371,57 @@ public:
      */
     int8_t scanNetworks();
 
+    /*
+     * Start scan WiFi networks available, without waiting for the result
+     *
+     * return: WL_SUCCESS if the scan was started, else WL_FAILURE
+     */
+    int8_t startScan();
+
+    /*
+     * Start scan WiFi networks available, reporting only the networks matching
+     * the filter. The module always scans all the channels, so the scan takes
+     * as long as an unfiltered one. The networks are filtered once the scan
+     * completes, and the results of the scan functions only count and index
+     * the networks kept.
+     *
+     * return: WL_SUCCESS if the scan was started, else WL_FAILURE
+     */
+    int8_t startScan(const WiFiScanFilter& filter);
+
+    /*
+     * Check whether the scan started by startScan() is complete. The module
+     * only scans once asked for the result: the first call made
+     * WIFI_SCAN_DELAY milliseconds or more after startScan() blocks for the
+     * whole scan, a few seconds, and completes it, even with no network.
+     *
+     * return: Number of discovered networks, WIFI_SCAN_RUNNING while the
+     *         scan is running or WIFI_SCAN_FAILED if no scan was started
+     */
+    int8_t scanComplete();
+
+    /*
+     * Call the function with the result of scanComplete() once the scan
+     * started by startScan() completes, from poll().
+     */
+    void onScanComplete(WiFiScanCallback callback);
+
+    /*
+     * Get all the information about the networks discovered by the last scan.
+     *
+     * param results: array receiving one entry per network
+     * param max: size of the array
+     *
+     * return: number of entries filled
+     */
+    uint8_t scanResults(WiFiScanResult results[], uint8_t max);
+    bool scanResult(uint8_t networkItem, WiFiScanResult& result);
+
+    /*
+     * Return the number of networks discovered by the last scan
+     */
+    uint8_t scanCount() { return _scanCount; }
+
     /*
      * Return the SSID discovered during the network scan.
      *
@@ -277,6 +475,55 @@ public:
      */
     int hostByName(const char* aHostname, IPAddress& aResult);
 
+    /*
+     * Keep the addresses returned by hostByName() so that names resolved again
+     * are answered without asking the module. When enabled, the cache is also
+     * used by WiFiClient::connect(), WiFiUDP::beginPacket() and ping().
+     * param entries: number of names kept, the least recently used is replaced
+     *                when full, 0 disables the cache
+     * param lifetime: time in milliseconds an address is kept
+     * result: true if the cache is enabled
+     */
+    bool setDnsCache(uint8_t entries = WIFI_DNS_CACHE_DEFAULT_ENTRIES,
+                     unsigned long lifetime = WIFI_DNS_CACHE_DEFAULT_LIFETIME);
+    uint32_t dnsCacheHits();
+    uint32_t dnsCacheMisses();
+
+    /*
+     * Resolve several hostnames. Names given more than once are looked up
+     * once, and names in the DNS cache are not looked up at all.
+     * param aHostnames: Names to be resolved
+     * param aResults: IPAddress array receiving the addresses, 0.0.0.0 for
+     *                 the names that couldn't be resolved
+     * param count: number of names
+     * result: number of names resolved
+     */
+    int resolveMany(const char* const aHostnames[], IPAddress aResults[], uint8_t count);
+
+    /*
+     * Queue the given hostname, to be resolved later by poll(). This call
+     * returns at once, but the lookups still block: each poll() resolves at
+     * most one queued name and waits for its answer like hostByName().
+     * Names in the DNS cache are answered without waiting.
+     * param aHostname: Name to be resolved, must stay valid until resolved
+     * param callback: function called with the result, or NULL to use resolveResult()
+     * result: handle of the request, 0 if WIFI_RESOLVE_MAX_PENDING are already pending
+     */
+    int resolveDeferred(const char* aHostname, WiFiResolveCallback callback = NULL);
+
+    /*
+     * Get the result of a request started without callback.
+     * result: WIFI_RESOLVE_PENDING while running, else WIFI_RESOLVE_DONE with
+     *         aResult set or WIFI_RESOLVE_FAILED, and the handle is released
+     */
+    int resolveResult(int handle, IPAddress& aResult);
+    void resolveCancel(int handle);
+
+    /*
+     * Perform the pending background work, call it often from loop().
+     */
+    void poll();
+
     unsigned long getTime();
     int setTime(unsigned long unixTime);
 
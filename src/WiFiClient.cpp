@@ -29,6 +29,7 @@ extern "C" {
 #include "utility/server_drv.h"
 #include "utility/wifi_drv.h"
 #include "utility/WiFiSocketBuffer.h"
+#include "utility/WiFiDnsCache.h"
 
 #include "WiFi.h"
 #include "WiFiClient.h"
@@ -42,12 +43,38 @@ WiFiClient::WiFiClient(uint8_t sock) : _sock(sock), _retrySend(true) {
 }
 
 int WiFiClient::connect(const char* host, uint16_t port) {
-	IPAddress remote_addr;
-	if (WiFi.hostByName(host, remote_addr))
-	{
-		return connect(remote_addr, port);
-	}
-	return 0;
+    if (WiFiDnsCache.enabled())
+    {
+      // an address already known saves the lookup on the NINA
+      IPAddress remote_addr;
+      if (WiFi.hostByName(host, remote_addr) != 1)
+      {
+        return 0;
+      }
+      return connect(remote_addr, port);
+    }
+
+    if (_sock != NO_SOCKET_AVAIL)
+    {
+      stop();
+    }
+
+    _sock = ServerDrv::getSocket();
+    if (_sock != NO_SOCKET_AVAIL)
+    {
+      // let the NINA resolve the host as part of the connect request,
+      // saving the REQ_HOST_BY_NAME/GET_HOST_BY_NAME round trips
+      ServerDrv::startClient(host, strlen(host), uint32_t(0), port, _sock, TCP_MODE, _connTimeout);
+
+      if (!connected())
+        {
+        return 0;
+      }
+    } else {
+      Serial.println("No Socket available");
+      return 0;
+    }
+    return 1;
 }
 
 int WiFiClient::connect(IPAddress ip, uint16_t port) {
@@ -59,19 +86,63 @@ int WiFiClient::connect(IPAddress ip, uint16_t port) {
     _sock = ServerDrv::getSocket();
     if (_sock != NO_SOCKET_AVAIL)
     {
-    	ServerDrv::startClient(nullptr, 0, uint32_t(ip), port, _sock, TCP_MODE, _connTimeout);
+      ServerDrv::startClient(nullptr, 0, uint32_t(ip), port, _sock, TCP_MODE, _connTimeout);
 
-    	if (!connected())
-       	{
-    		return 0;
-    	}
+      if (!connected())
+        {
+        return 0;
+      }
     } else {
-    	Serial.println("No Socket available");
-    	return 0;
+      Serial.println("No Socket available");
+      return 0;
     }
     return 1;
 }
 
+int WiFiClient::connectAny(const IPAddress candidates[], uint8_t count, uint16_t port)
+{
+    if (_sock != NO_SOCKET_AVAIL)
+    {
+      stop();
+    }
+
+    if (count == 0)
+    {
+      return -1;
+    }
+
+    unsigned long budget = _connTimeout ? _connTimeout : WIFI_CLIENT_CONNECT_ANY_TIMEOUT;
+    uint16_t slice = budget / count;
+    if (slice < WIFI_CLIENT_CONNECT_ANY_MIN_SLICE)
+    {
+      slice = WIFI_CLIENT_CONNECT_ANY_MIN_SLICE;
+    }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+      uint8_t sock = ServerDrv::getSocket();
+      if (sock == NO_SOCKET_AVAIL)
+      {
+        Serial.println("No Socket available");
+        break;
+      }
+
+      ServerDrv::startClient(nullptr, 0, uint32_t(candidates[i]), port, sock, TCP_MODE, slice);
+
+      if (ServerDrv::getClientState(sock) == ESTABLISHED)
+      {
+        _sock = sock;
+        return i;
+      }
+
+      // don't wait for the failed attempt to close, the NINA
+      // releases the socket while the next candidate is tried
+      ServerDrv::stopClient(sock);
+      WiFiSocketBuffer.close(sock);
+    }
+    return -1;
+}
+
 int WiFiClient::connectSSL(IPAddress ip, uint16_t port)
 {
     if (_sock != NO_SOCKET_AVAIL)
@@ -207,6 +278,7 @@ size_t WiFiClient::write(const uint8_t *buf, size_t size) {
     return 0;
   }
 
+  WiFiSocketBuffer.touch(_sock);
   return written;
 }
 
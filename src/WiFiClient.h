@@ -25,6 +25,11 @@
 #include "Client.h"
 #include "IPAddress.h"
 
+// Overall time budget of connectAny() when no connection timeout is set
+#define WIFI_CLIENT_CONNECT_ANY_TIMEOUT 10000
+// Shortest time given to a single candidate of connectAny()
+#define WIFI_CLIENT_CONNECT_ANY_MIN_SLICE 250
+
 class WiFiClient : public Client {
 
 public:
@@ -36,6 +41,14 @@ public:
 
   virtual int connect(IPAddress ip, uint16_t port);
   virtual int connect(const char *host, uint16_t port);
+  /*
+   * Connect to the first reachable endpoint out of a list of redundant
+   * candidates. The connection timeout is shared between the candidates,
+   * so the worst case is bounded by one timeout instead of count of them.
+   *
+   * return: index of the connected candidate, or -1 if none was reachable
+   */
+  int connectAny(const IPAddress candidates[], uint8_t count, uint16_t port);
   virtual int connectSSL(IPAddress ip, uint16_t port);
   virtual int connectSSL(const char *host, uint16_t port);
   virtual int connectBearSSL(IPAddress ip, uint16_t port);
@@ -60,6 +73,7 @@ public:
 
   friend class WiFiServer;
   friend class WiFiDrv;
+  friend class WiFiHttpServer;
 
   using Print::write;
 
@@ -0,0 +1,743 @@
+/*
+  WiFiHttpServer.cpp - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+
+#include "utility/server_drv.h"
+#include "utility/WiFiSocketBuffer.h"
+
+#include "WiFiHttpServer.h"
+
+// Room left at the end of the buffer for the chunk trailer and the last chunk
+#define CHUNK_TRAILER_SIZE 7
+// Zero padded chunk size followed by CRLF
+#define CHUNK_HEADER_SIZE 6
+
+enum {
+  HEADER_OTHER,
+  HEADER_CONTENT_LENGTH,
+  HEADER_CONNECTION,
+  HEADER_TRANSFER_ENCODING
+};
+
+static const char STATUS_200[] PROGMEM = "HTTP/1.1 200 OK\r\n";
+static const char STATUS_201[] PROGMEM = "HTTP/1.1 201 Created\r\n";
+static const char STATUS_204[] PROGMEM = "HTTP/1.1 204 No Content\r\n";
+static const char STATUS_301[] PROGMEM = "HTTP/1.1 301 Moved Permanently\r\n";
+static const char STATUS_302[] PROGMEM = "HTTP/1.1 302 Found\r\n";
+static const char STATUS_304[] PROGMEM = "HTTP/1.1 304 Not Modified\r\n";
+static const char STATUS_400[] PROGMEM = "HTTP/1.1 400 Bad Request\r\n";
+static const char STATUS_401[] PROGMEM = "HTTP/1.1 401 Unauthorized\r\n";
+static const char STATUS_403[] PROGMEM = "HTTP/1.1 403 Forbidden\r\n";
+static const char STATUS_404[] PROGMEM = "HTTP/1.1 404 Not Found\r\n";
+static const char STATUS_405[] PROGMEM = "HTTP/1.1 405 Method Not Allowed\r\n";
+static const char STATUS_413[] PROGMEM = "HTTP/1.1 413 Payload Too Large\r\n";
+static const char STATUS_414[] PROGMEM = "HTTP/1.1 414 URI Too Long\r\n";
+static const char STATUS_500[] PROGMEM = "HTTP/1.1 500 Internal Server Error\r\n";
+static const char STATUS_501[] PROGMEM = "HTTP/1.1 501 Not Implemented\r\n";
+static const char STATUS_503[] PROGMEM = "HTTP/1.1 503 Service Unavailable\r\n";
+
+static const char HEADER_CONTENT_TYPE_PREFIX[] PROGMEM = "Content-Type: ";
+static const char HEADER_CONTENT_LENGTH_PREFIX[] PROGMEM = "Content-Length: ";
+static const char HEADER_CHUNKED[] PROGMEM = "Transfer-Encoding: chunked\r\n";
+static const char HEADER_KEEP_ALIVE[] PROGMEM = "Connection: keep-alive\r\n";
+static const char HEADER_CLOSE[] PROGMEM = "Connection: close\r\n";
+static const char CRLF[] PROGMEM = "\r\n";
+static const char LAST_CHUNK[] PROGMEM = "0\r\n\r\n";
+
+static const char* statusLine(int status)
+{
+  switch (status) {
+    case 200: return STATUS_200;
+    case 201: return STATUS_201;
+    case 204: return STATUS_204;
+    case 301: return STATUS_301;
+    case 302: return STATUS_302;
+    case 304: return STATUS_304;
+    case 400: return STATUS_400;
+    case 401: return STATUS_401;
+    case 403: return STATUS_403;
+    case 404: return STATUS_404;
+    case 405: return STATUS_405;
+    case 413: return STATUS_413;
+    case 414: return STATUS_414;
+    case 500: return STATUS_500;
+    case 501: return STATUS_501;
+    case 503: return STATUS_503;
+    default: return NULL;
+  }
+}
+
+static bool tokenEquals(const char* token, uint8_t len, const char* str)
+{
+  return (len == strlen(str)) && (len <= WIFI_HTTP_MAX_TOKEN) && (memcmp(token, str, len) == 0);
+}
+
+static char toLower(char c)
+{
+  return (c >= 'A' && c <= 'Z') ? (c - 'A' + 'a') : c;
+}
+
+int WiFiHttpRequest::available()
+{
+  int avail = WiFiSocketBuffer.available(_sock);
+
+  if ((uint32_t)avail > _remaining) {
+    avail = _remaining;
+  }
+  return avail;
+}
+
+int WiFiHttpRequest::read(uint8_t* buf, size_t size)
+{
+  if (size > _remaining) {
+    size = _remaining;
+  }
+  if (size == 0) {
+    return 0;
+  }
+
+  int result = WiFiSocketBuffer.read(_sock, buf, size);
+  _remaining -= result;
+
+  return result;
+}
+
+void WiFiHttpResponse::reset(uint8_t sock, bool keepAlive, bool http10, bool headOnly)
+{
+  _sock = sock;
+  _keepAlive = keepAlive;
+  _http10 = http10;
+  _headOnly = headOnly;
+  _begun = false;
+  _chunked = false;
+  _failed = false;
+  _len = 0;
+  _chunkStart = 0;
+  clearWriteError();
+}
+
+void WiFiHttpResponse::begin(int status, const char* contentType, long contentLength)
+{
+  if (_begun) {
+    return;
+  }
+  _begun = true;
+
+  const char* line = statusLine(status);
+  if (line != NULL) {
+    append(line, true);
+  } else {
+    append("HTTP/1.1 ");
+    appendNumber(status);
+    append(" \r\n");
+  }
+
+  if (contentType != NULL) {
+    append(HEADER_CONTENT_TYPE_PREFIX, true);
+    append(contentType);
+    append(CRLF, true);
+  }
+
+  if (contentLength >= 0) {
+    append(HEADER_CONTENT_LENGTH_PREFIX, true);
+    appendNumber(contentLength);
+    append(CRLF, true);
+  } else if (_http10) {
+    // no chunked encoding in HTTP/1.0, the end of the body is marked by closing
+    _keepAlive = false;
+  } else if (!_headOnly) {
+    append(HEADER_CHUNKED, true);
+    _chunked = true;
+  }
+
+  append(_keepAlive ? HEADER_KEEP_ALIVE : HEADER_CLOSE, true);
+  append(CRLF, true);
+
+  if (_chunked) {
+    openChunk();
+  }
+}
+
+bool WiFiHttpResponse::end()
+{
+  if (!_begun) {
+    begin(204, NULL, 0);
+  }
+
+  flush(true);
+
+  if (!_failed && !ServerDrv::checkDataSent(_sock)) {
+    _failed = true;
+  }
+  return !_failed;
+}
+
+bool WiFiHttpResponse::sendFile(WiFiStorageFile& file, const char* contentType)
+{
+  // the status line and the Content-Length of the file can't be sent anymore
+  if (_begun) {
+    return false;
+  }
+
+  if (!file) {
+    begin(404, NULL, 0);
+    return false;
+  }
+
+  uint32_t left = file.size();
+  begin(200, contentType, left);
+  if (_headOnly) {
+    return true;
+  }
+
+  // read the file straight into the transmit buffer, behind the headers
+  size_t limit = _chunked ? (sizeof(_buffer) - CHUNK_TRAILER_SIZE) : sizeof(_buffer);
+
+  file.seek(0);
+  while (left && !_failed) {
+    size_t n = limit - _len;
+    if (n > WIFI_STORAGE_MAX_READ) {
+      n = WIFI_STORAGE_MAX_READ;
+    }
+    if (n > left) {
+      n = left;
+    }
+
+    n = file.read(&_buffer[_len], n);
+    if (n == 0) {
+      break;
+    }
+    _len += n;
+    left -= n;
+
+    if (_len == limit) {
+      flush(false);
+    }
+  }
+  return !_failed && !left;
+}
+
+size_t WiFiHttpResponse::write(const uint8_t *buf, size_t size)
+{
+  if (!_begun) {
+    begin(200);
+  }
+  if (_headOnly) {
+    return size;
+  }
+
+  size_t limit = _chunked ? (sizeof(_buffer) - CHUNK_TRAILER_SIZE) : sizeof(_buffer);
+  size_t left = size;
+
+  while (left) {
+    size_t n = limit - _len;
+    if (n > left) {
+      n = left;
+    }
+    memcpy(&_buffer[_len], buf, n);
+    _len += n;
+    buf += n;
+    left -= n;
+
+    if (_len == limit && !flush(false)) {
+      setWriteError();
+      return size - left;
+    }
+  }
+  return size;
+}
+
+void WiFiHttpResponse::append(const char* str, bool flash)
+{
+  size_t len = flash ? strlen_P(str) : strlen(str);
+
+  while (len) {
+    size_t n = sizeof(_buffer) - _len;
+    if (n > len) {
+      n = len;
+    }
+    if (flash) {
+      memcpy_P(&_buffer[_len], str, n);
+    } else {
+      memcpy(&_buffer[_len], str, n);
+    }
+    _len += n;
+    str += n;
+    len -= n;
+
+    if (_len == sizeof(_buffer)) {
+      flush(false);
+    }
+  }
+}
+
+void WiFiHttpResponse::appendNumber(unsigned long n)
+{
+  char digits[11];
+  int i = sizeof(digits) - 1;
+
+  digits[i] = '\0';
+  do {
+    digits[--i] = '0' + (n % 10);
+    n /= 10;
+  } while (n);
+
+  append(&digits[i]);
+}
+
+void WiFiHttpResponse::openChunk()
+{
+  if (_len + CHUNK_HEADER_SIZE + CHUNK_TRAILER_SIZE >= sizeof(_buffer)) {
+    flush(false);
+  }
+  _len += CHUNK_HEADER_SIZE;
+  _chunkStart = _len;
+}
+
+bool WiFiHttpResponse::flush(bool last)
+{
+  bool chunk = (_chunkStart != 0);
+
+  if (chunk) {
+    size_t size = _len - _chunkStart;
+    size_t header = _chunkStart - CHUNK_HEADER_SIZE;
+
+    if (size) {
+      static const char hex[] = "0123456789ABCDEF";
+
+      _buffer[header + 0] = hex[(size >> 12) & 0x0F];
+      _buffer[header + 1] = hex[(size >> 8) & 0x0F];
+      _buffer[header + 2] = hex[(size >> 4) & 0x0F];
+      _buffer[header + 3] = hex[size & 0x0F];
+      _buffer[header + 4] = '\r';
+      _buffer[header + 5] = '\n';
+      _buffer[_len++] = '\r';
+      _buffer[_len++] = '\n';
+    } else {
+      // drop the header reserved for an empty chunk
+      _len = header;
+    }
+
+    if (last) {
+      memcpy_P(&_buffer[_len], LAST_CHUNK, strlen_P(LAST_CHUNK));
+      _len += strlen_P(LAST_CHUNK);
+    }
+  }
+
+  bool result = send(_buffer, _len);
+  _len = 0;
+  _chunkStart = 0;
+
+  if (chunk && !last) {
+    openChunk();
+  }
+  return result;
+}
+
+bool WiFiHttpResponse::send(const uint8_t* data, size_t len)
+{
+  while (len && !_failed) {
+    uint16_t written = 0;
+
+    for (int i = 0; i < 5 && !written; i++) {
+      written = ServerDrv::sendData(_sock, data, len);
+    }
+    if (!written) {
+      _failed = true;
+    }
+    data += written;
+    len -= written;
+  }
+  WiFiSocketBuffer.touch(_sock);
+  return !_failed;
+}
+
+WiFiHttpServer::WiFiHttpServer(WiFiServer& server, const WiFiHttpRoute routes[], uint8_t count) :
+  _server(server),
+  _routes(routes),
+  _count(count)
+{
+  for (uint8_t i = 0; i < WIFI_HTTP_MAX_CONNECTIONS; i++) {
+    _connections[i].sock = NO_SOCKET_AVAIL;
+    _connections[i].state = ST_IDLE;
+  }
+}
+
+void WiFiHttpServer::begin()
+{
+  _server.begin();
+}
+
+void WiFiHttpServer::end()
+{
+  for (uint8_t i = 0; i < WIFI_HTTP_MAX_CONNECTIONS; i++) {
+    if (_connections[i].sock != NO_SOCKET_AVAIL) {
+      close(_connections[i]);
+    }
+  }
+  _server.end();
+}
+
+void WiFiHttpServer::poll()
+{
+  accept();
+
+  for (uint8_t i = 0; i < WIFI_HTTP_MAX_CONNECTIONS; i++) {
+    Connection& conn = _connections[i];
+
+    if (conn.sock == NO_SOCKET_AVAIL) {
+      continue;
+    }
+
+    if (conn.generation != WiFiSocketBuffer.generation(conn.sock)) {
+      // the socket was closed elsewhere, by WiFiServer::restart() for one,
+      // its number may now belong to an unrelated connection
+      close(conn);
+    } else {
+      service(conn);
+    }
+  }
+}
+
+void WiFiHttpServer::accept()
+{
+  WiFiClient client = _server.accept();
+
+  if (!client) {
+    return;
+  }
+
+  for (uint8_t i = 0; i < WIFI_HTTP_MAX_CONNECTIONS; i++) {
+    Connection& conn = _connections[i];
+
+    if (conn.sock == NO_SOCKET_AVAIL) {
+      conn.sock = client._sock;
+      conn.generation = WiFiSocketBuffer.generation(client._sock);
+      conn.lastActivity = millis();
+      restart(conn);
+      return;
+    }
+  }
+
+  error(client._sock, 503);
+  ServerDrv::stopClient(client._sock);
+  WiFiSocketBuffer.close(client._sock);
+}
+
+void WiFiHttpServer::service(Connection& conn)
+{
+  const uint8_t* data;
+  int avail = WiFiSocketBuffer.view(conn.sock, &data);
+
+  if (avail <= 0) {
+    if ((millis() - conn.lastActivity) > WIFI_HTTP_KEEPALIVE_TIMEOUT) {
+      close(conn);
+    }
+    return;
+  }
+  conn.lastActivity = millis();
+
+  if (conn.state == ST_DISCARD) {
+    // drop the body the handler did not read
+    if ((uint32_t)avail > conn.contentLength) {
+      avail = conn.contentLength;
+    }
+    WiFiSocketBuffer.skip(conn.sock, avail);
+    conn.contentLength -= avail;
+    if (conn.contentLength == 0) {
+      restart(conn);
+    }
+    return;
+  }
+
+  bool done = false;
+  size_t used = parse(conn, data, avail, done);
+  WiFiSocketBuffer.skip(conn.sock, used);
+
+  if (conn.status) {
+    error(conn.sock, conn.status);
+    close(conn);
+  } else if (done) {
+    dispatch(conn);
+  }
+}
+
+size_t WiFiHttpServer::parse(Connection& conn, const uint8_t* data, size_t len, bool& done)
+{
+  for (size_t i = 0; i < len; i++) {
+    char c = data[i];
+
+    if (++conn.headerSize > WIFI_HTTP_MAX_HEADER_SIZE) {
+      conn.status = 400;
+      return i;
+    }
+
+    switch (conn.state) {
+      case ST_METHOD:
+        if (c == ' ') {
+          if (tokenEquals(conn.token, conn.tokenLen, "GET")) {
+            conn.method = WIFI_HTTP_GET;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "HEAD")) {
+            conn.method = WIFI_HTTP_HEAD;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "POST")) {
+            conn.method = WIFI_HTTP_POST;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "PUT")) {
+            conn.method = WIFI_HTTP_PUT;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "DELETE")) {
+            conn.method = WIFI_HTTP_DELETE;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "OPTIONS")) {
+            conn.method = WIFI_HTTP_OPTIONS;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "PATCH")) {
+            conn.method = WIFI_HTTP_PATCH;
+          } else {
+            conn.status = 501;
+            return i;
+          }
+          conn.tokenLen = 0;
+          conn.state = ST_PATH;
+        } else if (c == '\r' || c == '\n') {
+          // tolerate empty lines between pipelined requests
+          if (conn.tokenLen) {
+            conn.status = 400;
+            return i;
+          }
+        } else {
+          if (conn.tokenLen < WIFI_HTTP_MAX_TOKEN) {
+            conn.token[conn.tokenLen] = c;
+          }
+          if (conn.tokenLen < 255) {
+            conn.tokenLen++;
+          }
+        }
+        break;
+
+      case ST_PATH:
+        if (c == ' ') {
+          conn.path[conn.pathLen] = '\0';
+          conn.state = ST_VERSION;
+        } else if (c == '\r' || c == '\n') {
+          conn.status = 400;
+          return i;
+        } else if (conn.pathLen < (WIFI_HTTP_MAX_PATH - 1)) {
+          conn.path[conn.pathLen++] = c;
+        } else {
+          conn.status = 414;
+          return i;
+        }
+        break;
+
+      case ST_VERSION:
+        if (c == '\n') {
+          if (tokenEquals(conn.token, conn.tokenLen, "HTTP/1.1")) {
+            conn.keepAlive = true;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "HTTP/1.0")) {
+            conn.http10 = true;
+          } else {
+            conn.status = 400;
+            return i;
+          }
+          conn.tokenLen = 0;
+          conn.state = ST_HEADER_NAME;
+        } else if (c != '\r') {
+          if (conn.tokenLen < WIFI_HTTP_MAX_TOKEN) {
+            conn.token[conn.tokenLen] = c;
+          }
+          if (conn.tokenLen < 255) {
+            conn.tokenLen++;
+          }
+        }
+        break;
+
+      case ST_HEADER_NAME:
+        if (c == '\n') {
+          if (conn.tokenLen) {
+            conn.status = 400;
+            return i;
+          }
+          // empty line, the body (if any) stays in the socket buffer
+          done = true;
+          return i + 1;
+        } else if (c == ':') {
+          if (tokenEquals(conn.token, conn.tokenLen, "content-length")) {
+            conn.header = HEADER_CONTENT_LENGTH;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "connection")) {
+            conn.header = HEADER_CONNECTION;
+          } else if (tokenEquals(conn.token, conn.tokenLen, "transfer-encoding")) {
+            conn.header = HEADER_TRANSFER_ENCODING;
+          } else {
+            conn.header = HEADER_OTHER;
+          }
+          conn.tokenLen = 0;
+          conn.state = ST_HEADER_VALUE;
+        } else if (c != '\r') {
+          if (conn.tokenLen < WIFI_HTTP_MAX_TOKEN) {
+            conn.token[conn.tokenLen] = toLower(c);
+          }
+          if (conn.tokenLen < 255) {
+            conn.tokenLen++;
+          }
+        }
+        break;
+
+      case ST_HEADER_VALUE:
+        if (c == '\n') {
+          endHeaderLine(conn);
+          if (conn.status) {
+            return i;
+          }
+          conn.tokenLen = 0;
+          conn.state = ST_HEADER_NAME;
+        } else if (c == '\r' || (c == ' ' && conn.tokenLen == 0)) {
+          // skip leading white space
+        } else if (conn.header == HEADER_CONTENT_LENGTH) {
+          if (c < '0' || c > '9') {
+            conn.status = 400;
+            return i;
+          }
+          uint32_t digit = c - '0';
+
+          // stop before the value can overflow
+          if (conn.contentLength > (WIFI_HTTP_MAX_BODY_SIZE - digit) / 10) {
+            conn.status = 413;
+            return i;
+          }
+          conn.contentLength = conn.contentLength * 10 + digit;
+        } else if (conn.header != HEADER_OTHER) {
+          if (conn.tokenLen < WIFI_HTTP_MAX_TOKEN) {
+            conn.token[conn.tokenLen] = toLower(c);
+          }
+          if (conn.tokenLen < 255) {
+            conn.tokenLen++;
+          }
+        }
+        break;
+    }
+  }
+  return len;
+}
+
+void WiFiHttpServer::endHeaderLine(Connection& conn)
+{
+  if (conn.header == HEADER_CONNECTION) {
+    if (tokenEquals(conn.token, conn.tokenLen, "close")) {
+      conn.keepAlive = false;
+    } else if (tokenEquals(conn.token, conn.tokenLen, "keep-alive")) {
+      conn.keepAlive = true;
+    }
+  } else if (conn.header == HEADER_TRANSFER_ENCODING) {
+    // chunked request bodies are not supported
+    conn.status = 501;
+  }
+}
+
+void WiFiHttpServer::dispatch(Connection& conn)
+{
+  WiFiHttpRequest request;
+  char* query = strchr(conn.path, '?');
+
+  if (query != NULL) {
+    *query++ = '\0';
+  } else {
+    query = &conn.path[conn.pathLen];
+  }
+
+  request._sock = conn.sock;
+  request._method = conn.method;
+  request._path = conn.path;
+  request._query = query;
+  request._contentLength = conn.contentLength;
+  request._remaining = conn.contentLength;
+
+  // HEAD is served by the GET handlers, without the body
+  uint8_t mask = (conn.method == WIFI_HTTP_HEAD) ? (WIFI_HTTP_HEAD | WIFI_HTTP_GET) : conn.method;
+  WiFiHttpHandler handler = NULL;
+  bool found = false;
+
+  for (uint8_t i = 0; i < _count && handler == NULL; i++) {
+    const char* path = _routes[i].path;
+    size_t len = strlen(path);
+    bool match;
+
+    if (len && path[len - 1] == '*') {
+      match = (strncmp(conn.path, path, len - 1) == 0);
+    } else {
+      match = (strcmp(conn.path, path) == 0);
+    }
+
+    if (match) {
+      found = true;
+      if (_routes[i].method & mask) {
+        handler = _routes[i].handler;
+      }
+    }
+  }
+
+  _response.reset(conn.sock, conn.keepAlive, conn.http10, conn.method == WIFI_HTTP_HEAD);
+
+  if (handler != NULL) {
+    handler(request, _response);
+  } else {
+    _response.begin(found ? 405 : 404, NULL, 0);
+  }
+
+  if (!_response.end() || !_response._keepAlive) {
+    close(conn);
+  } else if (request._remaining) {
+    conn.contentLength = request._remaining;
+    conn.state = ST_DISCARD;
+  } else {
+    restart(conn);
+  }
+}
+
+void WiFiHttpServer::error(uint8_t sock, int status)
+{
+  _response.reset(sock, false, false, false);
+  _response.begin(status, NULL, 0);
+  _response.end();
+}
+
+void WiFiHttpServer::close(Connection& conn)
+{
+  // a socket closed elsewhere is only forgotten, don't stop the
+  // connection that may have reused its number
+  if (conn.generation == WiFiSocketBuffer.generation(conn.sock)) {
+    // don't wait for the connection to be closed, the NINA completes it
+    ServerDrv::stopClient(conn.sock);
+    WiFiSocketBuffer.close(conn.sock);
+  }
+
+  conn.sock = NO_SOCKET_AVAIL;
+  conn.state = ST_IDLE;
+}
+
+void WiFiHttpServer::restart(Connection& conn)
+{
+  conn.state = ST_METHOD;
+  conn.method = 0;
+  conn.header = HEADER_OTHER;
+  conn.keepAlive = false;
+  conn.http10 = false;
+  conn.status = 0;
+  conn.tokenLen = 0;
+  conn.pathLen = 0;
+  conn.headerSize = 0;
+  conn.contentLength = 0;
+}
@@ -0,0 +1,203 @@
+/*
+  WiFiHttpServer.h - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef wifihttpserver_h
+#define wifihttpserver_h
+
+#include "WiFi.h"
+
+#ifdef __AVR__
+#define WIFI_HTTP_MAX_CONNECTIONS 4
+#define WIFI_HTTP_MAX_PATH 32
+#define WIFI_HTTP_TX_BUFFER_SIZE 64
+#else
+#define WIFI_HTTP_MAX_CONNECTIONS 8
+#define WIFI_HTTP_MAX_PATH 128
+#define WIFI_HTTP_TX_BUFFER_SIZE 1024
+#endif
+// Longest header name or value the parser keeps track of
+#define WIFI_HTTP_MAX_TOKEN 20
+// Largest accepted request line plus headers
+#define WIFI_HTTP_MAX_HEADER_SIZE 4096
+// Largest accepted request body, larger ones are answered with 413
+#define WIFI_HTTP_MAX_BODY_SIZE 1048576UL
+// Idle keep-alive connections are closed after this many milliseconds
+#define WIFI_HTTP_KEEPALIVE_TIMEOUT 5000
+
+enum {
+  WIFI_HTTP_GET     = 0x01,
+  WIFI_HTTP_HEAD    = 0x02,
+  WIFI_HTTP_POST    = 0x04,
+  WIFI_HTTP_PUT     = 0x08,
+  WIFI_HTTP_DELETE  = 0x10,
+  WIFI_HTTP_OPTIONS = 0x20,
+  WIFI_HTTP_PATCH   = 0x40,
+  WIFI_HTTP_ANY     = 0x7F
+};
+
+class WiFiHttpRequest;
+class WiFiHttpResponse;
+
+typedef void (*WiFiHttpHandler)(WiFiHttpRequest& request, WiFiHttpResponse& response);
+
+/*
+ * Entry of the route table given to WiFiHttpServer.
+ *
+ * method: mask of the WIFI_HTTP_* methods handled
+ * path: exact path to match, or a prefix when it ends with '*'
+ */
+struct WiFiHttpRoute {
+  uint8_t method;
+  const char* path;
+  WiFiHttpHandler handler;
+};
+
+class WiFiHttpRequest {
+public:
+  uint8_t method() { return _method; }
+  const char* path() { return _path; }
+  // part of the target following '?', empty if there is none
+  const char* query() { return _query; }
+  uint32_t contentLength() { return _contentLength; }
+
+  // Body bytes received so far and not yet read
+  int available();
+  int read(uint8_t* buf, size_t size);
+
+  uint8_t socket() { return _sock; }
+
+private:
+  friend class WiFiHttpServer;
+
+  uint8_t _sock;
+  uint8_t _method;
+  const char* _path;
+  const char* _query;
+  uint32_t _contentLength;
+  uint32_t _remaining;
+};
+
+class WiFiHttpResponse : public Print {
+public:
+  /*
+   * Send the status line and headers.
+   *
+   * param status: HTTP status code
+   * param contentType: value of the Content-Type header, or NULL
+   * param contentLength: body size, or -1 to stream the body with chunked encoding
+   */
+  void begin(int status, const char* contentType = NULL, long contentLength = -1);
+  // Flush the buffered response and complete the body
+  bool end();
+
+  /*
+   * Send a file from WiFiStorage as the whole response, instead of begin()
+   * and write(). Replies 404 if the file doesn't exist. Returns false
+   * without sending anything once begin() or write() has been called.
+   */
+  bool sendFile(WiFiStorageFile& file, const char* contentType = NULL);
+
+  virtual size_t write(uint8_t b) { return write(&b, 1); }
+  virtual size_t write(const uint8_t *buf, size_t size);
+
+  using Print::write;
+
+private:
+  friend class WiFiHttpServer;
+
+  void reset(uint8_t sock, bool keepAlive, bool http10, bool headOnly);
+  void append(const char* str, bool flash = false);
+  void appendNumber(unsigned long n);
+  void openChunk();
+  bool flush(bool last);
+  bool send(const uint8_t* data, size_t len);
+
+  uint8_t _sock;
+  bool _keepAlive;
+  bool _http10;
+  bool _headOnly;
+  bool _begun;
+  bool _chunked;
+  bool _failed;
+  size_t _len;
+  size_t _chunkStart;
+  uint8_t _buffer[WIFI_HTTP_TX_BUFFER_SIZE];
+};
+
+/*
+ * HTTP/1.1 server working on top of a WiFiServer.
+ *
+ * Requests are parsed in place in the socket buffers, connections are kept
+ * alive between requests and responses are coalesced into few SPI transfers.
+ * Call poll() from loop() to serve the clients.
+ */
+class WiFiHttpServer {
+public:
+  WiFiHttpServer(WiFiServer& server, const WiFiHttpRoute routes[], uint8_t count);
+
+  void begin();
+  void end();
+  void poll();
+
+private:
+  enum {
+    ST_IDLE,
+    ST_METHOD,
+    ST_PATH,
+    ST_VERSION,
+    ST_HEADER_NAME,
+    ST_HEADER_VALUE,
+    ST_DISCARD
+  };
+
+  struct Connection {
+    uint8_t sock;
+    uint8_t generation;
+    uint8_t state;
+    uint8_t method;
+    uint8_t header;
+    bool keepAlive;
+    bool http10;
+    uint16_t status;
+    uint8_t tokenLen;
+    uint8_t pathLen;
+    uint16_t headerSize;
+    uint32_t contentLength;
+    unsigned long lastActivity;
+    char token[WIFI_HTTP_MAX_TOKEN];
+    char path[WIFI_HTTP_MAX_PATH];
+  };
+
+  void accept();
+  void service(Connection& conn);
+  size_t parse(Connection& conn, const uint8_t* data, size_t len, bool& done);
+  void endHeaderLine(Connection& conn);
+  void dispatch(Connection& conn);
+  void error(uint8_t sock, int status);
+  void close(Connection& conn);
+  void restart(Connection& conn);
+
+  WiFiServer& _server;
+  const WiFiHttpRoute* _routes;
+  uint8_t _count;
+  Connection _connections[WIFI_HTTP_MAX_CONNECTIONS];
+  WiFiHttpResponse _response;
+};
+
+#endif
@@ -0,0 +1,160 @@
+/*
+  WiFiScanStore.cpp - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+
+#include "WiFiScanStore.h"
+
+WiFiScanStore::WiFiScanStore(WiFiScanResult entries[], uint8_t capacity) :
+  _entries(entries),
+  _capacity(capacity),
+  _count(0),
+  _generation(0)
+{
+}
+
+uint8_t WiFiScanStore::addScan()
+{
+  WiFiScanResult result;
+  uint8_t total = WiFi.scanCount();
+
+  _generation++;
+
+  // one result at a time, so no room is needed for a whole scan
+  for (uint8_t i = 0; i < total; i++) {
+    if (WiFi.scanResult(i, result)) {
+      add(result);
+    }
+  }
+  return _count;
+}
+
+bool WiFiScanStore::add(const WiFiScanResult& result)
+{
+  int index = indexOf(result);
+
+  if (index >= 0) {
+    // within a scan keep the strongest access point of the network, a newer
+    // scan replaces the entry even when weaker as the old reading is stale
+    if (_entries[index].generation == _generation && _entries[index].rssi >= result.rssi) {
+      return false;
+    }
+    remove(index);
+  } else if (_count == _capacity) {
+    if (_count == 0 || result.rssi <= _entries[_count - 1].rssi) {
+      return false;
+    }
+    // drop the weakest entry
+    _count--;
+  }
+
+  uint8_t position = _count;
+
+  while (position > 0 && _entries[position - 1].rssi < result.rssi) {
+    _entries[position] = _entries[position - 1];
+    position--;
+  }
+  _entries[position] = result;
+  _entries[position].generation = _generation;
+  _count++;
+  return true;
+}
+
+uint8_t WiFiScanStore::expire(uint8_t scans)
+{
+  uint8_t dropped = 0;
+
+  for (uint8_t i = 0; i < _count;) {
+    // unsigned difference, right across the wrap of the counter
+    uint8_t age = _generation - _entries[i].generation;
+
+    if (age >= scans) {
+      remove(i);
+      dropped++;
+    } else {
+      i++;
+    }
+  }
+  return dropped;
+}
+
+const WiFiScanResult* WiFiScanStore::strongest(const char* ssid)
+{
+  // entries are sorted, the first match is the strongest
+  for (uint8_t i = 0; i < _count; i++) {
+    if (strcmp(_entries[i].ssid, ssid) == 0) {
+      return &_entries[i];
+    }
+  }
+  return NULL;
+}
+
+const WiFiScanResult* WiFiScanStore::find(const uint8_t* bssid)
+{
+  int index = indexOf(bssid);
+
+  return (index >= 0) ? &_entries[index] : NULL;
+}
+
+uint8_t WiFiScanStore::count(const char* ssid)
+{
+  uint8_t matches = 0;
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (strcmp(_entries[i].ssid, ssid) == 0) {
+      matches++;
+    }
+  }
+  return matches;
+}
+
+int WiFiScanStore::indexOf(const WiFiScanResult& result)
+{
+  // hidden networks all share the empty SSID, tell them apart by access point
+  bool hidden = (result.ssid[0] == '\0');
+
+  for (uint8_t i = 0; i < _count; i++) {
+    if (_entries[i].encryptionType != result.encryptionType ||
+        strcmp(_entries[i].ssid, result.ssid) != 0) {
+      continue;
+    }
+    if (!hidden || memcmp(_entries[i].bssid, result.bssid, WL_MAC_ADDR_LENGTH) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+int WiFiScanStore::indexOf(const uint8_t* bssid)
+{
+  for (uint8_t i = 0; i < _count; i++) {
+    if (memcmp(_entries[i].bssid, bssid, WL_MAC_ADDR_LENGTH) == 0) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+void WiFiScanStore::remove(uint8_t index)
+{
+  for (uint8_t i = index + 1; i < _count; i++) {
+    _entries[i - 1] = _entries[i];
+  }
+  _count--;
+}
@@ -0,0 +1,76 @@
+/*
+  WiFiScanStore.h - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef wifiscanstore_h
+#define wifiscanstore_h
+
+#include "WiFi.h"
+
+/*
+ * Collection of scan results kept in storage given by the sketch.
+ *
+ * Results of several scans can be merged into the store, which then holds
+ * more networks than a single scan returns. A network is identified by its
+ * SSID and encryption type, and takes a single entry holding its strongest
+ * access point, so that the access points of one network don't fill the
+ * store. Hidden networks have no SSID and are identified by their BSSID.
+ * Each entry records the scan it was last seen in, expire() drops the ones
+ * that haven't been seen for a while. Entries are kept sorted from the
+ * strongest to the weakest signal, and the weakest one is dropped when the
+ * store is full.
+ */
+class WiFiScanStore {
+public:
+  WiFiScanStore(WiFiScanResult entries[], uint8_t capacity);
+
+  // Merge the results of the last scan as a new generation, return the number of entries
+  uint8_t addScan();
+  // Merge one result into the current generation, return false if it was
+  // not kept: weaker than all entries of a full store, or than an access
+  // point of the same network already seen in this generation
+  bool add(const WiFiScanResult& result);
+  // Drop the entries not seen in the last scans generations, return the number dropped
+  uint8_t expire(uint8_t scans);
+  void clear() { _count = 0; }
+
+  uint8_t count() { return _count; }
+  uint8_t capacity() { return _capacity; }
+  // Generation of the last addScan(), entries store the one they were last seen in
+  uint8_t generation() { return _generation; }
+  const WiFiScanResult& operator[](uint8_t index) { return _entries[index]; }
+
+  // Strongest entry with the given SSID, or NULL if there is none
+  const WiFiScanResult* strongest(const char* ssid);
+  // Entry whose strongest access point has the given BSSID, or NULL if there is none
+  const WiFiScanResult* find(const uint8_t* bssid);
+  // Number of entries with the given SSID, one per encryption type
+  uint8_t count(const char* ssid);
+
+private:
+  int indexOf(const WiFiScanResult& result);
+  int indexOf(const uint8_t* bssid);
+  void remove(uint8_t index);
+
+  WiFiScanResult* _entries;
+  uint8_t _capacity;
+  uint8_t _count;
+  uint8_t _generation;
+};
+
+#endif
@@ -20,6 +20,7 @@
 
 #include <string.h>
 #include "utility/server_drv.h"
+#include "utility/WiFiSocketBuffer.h"
 
 //extern "C" {
 //  #include "utility/debug.h"
@@ -31,14 +32,32 @@
 
 WiFiServer::WiFiServer() :
   _sock(NO_SOCKET_AVAIL),
-  _lastSock(NO_SOCKET_AVAIL)
+  _lastSock(NO_SOCKET_AVAIL),
+  _fair(false),
+  _clients(0),
+  _nextSock(0),
+  _checkSock(0),
+  _acceptDepth(0),
+  _acceptPeak(0),
+  _acceptFull(false),
+  _idleTimeout(0),
+  _lastReap(0)
 {
     _port = 80;
 }
 
 WiFiServer::WiFiServer(uint16_t port) :
   _sock(NO_SOCKET_AVAIL),
-  _lastSock(NO_SOCKET_AVAIL)
+  _lastSock(NO_SOCKET_AVAIL),
+  _fair(false),
+  _clients(0),
+  _nextSock(0),
+  _checkSock(0),
+  _acceptDepth(0),
+  _acceptPeak(0),
+  _acceptFull(false),
+  _idleTimeout(0),
+  _lastReap(0)
 {
     _port = port;
 }
@@ -66,14 +85,127 @@ void WiFiServer::end()
       ServerDrv::stopServer(_sock);
       _sock = NO_SOCKET_AVAIL;
       _lastSock = NO_SOCKET_AVAIL;
+      _clients = 0;
     }
 }
 
+void WiFiServer::addClient(uint8_t sock)
+{
+    if (sock < WIFI_MAX_SOCK_NUM) {
+        _clients |= (1 << sock);
+        _clientGeneration[sock] = WiFiSocketBuffer.generation(sock);
+        WiFiSocketBuffer.touch(sock);
+    }
+}
+
+void WiFiServer::removeClient(uint8_t sock)
+{
+    _clients &= ~(1 << sock);
+}
+
+bool WiFiServer::hasClient(uint8_t sock)
+{
+    if (!(_clients & (1 << sock))) {
+        return false;
+    }
+
+    // the socket was closed by a WiFiClient since it was accepted,
+    // its number may now belong to an unrelated connection
+    if (_clientGeneration[sock] != WiFiSocketBuffer.generation(sock)) {
+        removeClient(sock);
+        return false;
+    }
+    return true;
+}
+
+uint8_t WiFiServer::nextClient()
+{
+    // track new connections, they are served once they send data
+    addClient(ServerDrv::availServer(_sock, true));
+
+    uint8_t probes = 0;
+    uint8_t start = _nextSock;
+    for (uint8_t i = 0; i < WIFI_MAX_SOCK_NUM && probes < WIFI_SERVER_MAX_PROBES; i++) {
+        uint8_t sock = (start + i) % WIFI_MAX_SOCK_NUM;
+
+        if (!hasClient(sock)) {
+            continue;
+        }
+
+        // resume the next call after the last probed client
+        probes++;
+        _nextSock = (sock + 1) % WIFI_MAX_SOCK_NUM;
+        if (WiFiSocketBuffer.available(sock)) {
+            return sock;
+        }
+    }
+
+    // no client had data, check one of them for a closed connection
+    for (uint8_t i = 0; i < WIFI_MAX_SOCK_NUM; i++) {
+        uint8_t sock = _checkSock;
+        _checkSock = (_checkSock + 1) % WIFI_MAX_SOCK_NUM;
+
+        if (hasClient(sock)) {
+            if (ServerDrv::getClientState(sock) != ESTABLISHED && !WiFiSocketBuffer.available(sock)) {
+                removeClient(sock);
+            }
+            break;
+        }
+    }
+
+    return NO_SOCKET_AVAIL;
+}
+
+uint8_t WiFiServer::reapIdle()
+{
+    uint8_t closed = 0;
+    unsigned long now = millis();
+
+    _lastReap = now;
+    if (_idleTimeout == 0) {
+        return 0;
+    }
+
+    // only the timestamps are checked, fresh clients cost no request
+    for (uint8_t sock = 0; sock < WIFI_MAX_SOCK_NUM; sock++) {
+        if (hasClient(sock) && (now - WiFiSocketBuffer.lastActivity(sock)) > _idleTimeout) {
+            ServerDrv::stopClient(sock);
+            WiFiSocketBuffer.close(sock);
+            removeClient(sock);
+            if (_lastSock == sock) {
+                _lastSock = NO_SOCKET_AVAIL;
+            }
+            closed++;
+        }
+    }
+    return closed;
+}
+
+void WiFiServer::restart()
+{
+    // the clients died with the connection, free their sockets on the NINA
+    for (uint8_t sock = 0; sock < WIFI_MAX_SOCK_NUM; sock++) {
+        if (hasClient(sock)) {
+            ServerDrv::stopClient(sock);
+            WiFiSocketBuffer.close(sock);
+            removeClient(sock);
+        }
+    }
+    _lastSock = NO_SOCKET_AVAIL;
+    begin();
+}
+
 WiFiClient WiFiServer::available(byte* status)
 {
     int sock = NO_SOCKET_AVAIL;
 
-    if (_sock != NO_SOCKET_AVAIL) {
+    if (_idleTimeout && (millis() - _lastReap) > WIFI_SERVER_REAP_INTERVAL) {
+        reapIdle();
+    }
+
+    if (_sock != NO_SOCKET_AVAIL && _fair) {
+      sock = nextClient();
+    } else if (_sock != NO_SOCKET_AVAIL) {
       // check previous received client socket
       if (_lastSock != NO_SOCKET_AVAIL) {
           WiFiClient client(_lastSock);
@@ -97,6 +229,9 @@ WiFiClient WiFiServer::available(byte* status)
         }
 
         _lastSock = sock;
+        if (!hasClient(sock)) {
+            addClient(sock);
+        }
 
         return client;
     }
@@ -106,10 +241,40 @@ WiFiClient WiFiServer::available(byte* status)
 
 WiFiClient WiFiServer::accept()
 {
+    if (_idleTimeout && (millis() - _lastReap) > WIFI_SERVER_REAP_INTERVAL) {
+        reapIdle();
+    }
+
     int sock = ServerDrv::availServer(_sock, true);
+    addClient(sock);
     return WiFiClient(sock);
 }
 
+uint8_t WiFiServer::acceptMany(WiFiClient clients[], uint8_t max)
+{
+    uint8_t count = 0;
+
+    if (_sock != NO_SOCKET_AVAIL) {
+        while (count < max) {
+            uint8_t sock = ServerDrv::availServer(_sock, true);
+            if (sock == NO_SOCKET_AVAIL) {
+                break;
+            }
+            addClient(sock);
+            clients[count++] = WiFiClient(sock);
+        }
+    }
+
+    // the NINA can't tell how many connections are left without accepting
+    // them, when the array is full the depth is only a lower bound
+    _acceptDepth = count;
+    _acceptFull = (max > 0 && count == max);
+    if (count > _acceptPeak) {
+        _acceptPeak = count;
+    }
+    return count;
+}
+
 uint8_t WiFiServer::status() {
     if (_sock == NO_SOCKET_AVAIL) {
         return CLOSED;
@@ -150,3 +315,66 @@ size_t WiFiServer::write(const uint8_t *buffer, size_t size)
 
     return written;
 }
+
+uint8_t WiFiServer::broadcast(const uint8_t *buffer, size_t size, size_t results[])
+{
+    uint16_t sent = 0;
+    uint8_t delivered = 0;
+
+    if (results != NULL) {
+        memset(results, 0, WIFI_MAX_SOCK_NUM * sizeof(results[0]));
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    // queue the data on every client first, so that the transmissions
+    // overlap instead of waiting for each client in turn
+    for (uint8_t sock = 0; sock < WIFI_MAX_SOCK_NUM; sock++) {
+        if (!hasClient(sock)) {
+            continue;
+        }
+
+        // the NINA may take only part of the data, send the rest once it
+        // had time to empty its buffer
+        size_t written = 0;
+        for (int i = 0; i < 5 && written < size; i++) {
+            if (i) {
+                delay(10);
+            }
+            size_t chunk = size - written;
+            if (chunk > 0xFFFF) {
+                chunk = 0xFFFF;
+            }
+            written += ServerDrv::sendData(sock, buffer + written, chunk);
+        }
+        if (results != NULL) {
+            results[sock] = written;
+        }
+
+        if (written == size) {
+            sent |= (1 << sock);
+            WiFiSocketBuffer.touch(sock);
+        } else if (written) {
+            // the client would read the next data in the middle of this
+            // payload, close it rather than corrupt its stream
+            ServerDrv::stopClient(sock);
+            WiFiSocketBuffer.close(sock);
+            removeClient(sock);
+        }
+    }
+
+    for (uint8_t sock = 0; sock < WIFI_MAX_SOCK_NUM; sock++) {
+        if (!(sent & (1 << sock))) {
+            continue;
+        }
+
+        if (ServerDrv::checkDataSent(sock)) {
+            delivered++;
+        } else if (results != NULL) {
+            results[sock] = 0;
+        }
+    }
+
+    return delivered;
+}
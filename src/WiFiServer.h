@@ -27,6 +27,12 @@ extern "C" {
 
 #include "Server.h"
 
+// Maximum number of client sockets probed for data by a single
+// available() call when fair scheduling is enabled
+#define WIFI_SERVER_MAX_PROBES 4
+// Minimum time between two automatic sweeps for idle clients, in milliseconds
+#define WIFI_SERVER_REAP_INTERVAL 1000
+
 class WiFiClient;
 
 class WiFiServer : public Server {
@@ -35,16 +41,80 @@ private:
   uint8_t _lastSock;
   uint16_t _port;
   void*     pcb;
+  bool _fair;
+  // accepted client sockets, one bit per socket number
+  uint16_t _clients;
+  uint8_t _clientGeneration[WIFI_MAX_SOCK_NUM];
+  uint8_t _nextSock;
+  uint8_t _checkSock;
+  uint8_t _acceptDepth;
+  uint8_t _acceptPeak;
+  bool _acceptFull;
+  unsigned long _idleTimeout;
+  unsigned long _lastReap;
+
+  void addClient(uint8_t sock);
+  void removeClient(uint8_t sock);
+  bool hasClient(uint8_t sock);
+  uint8_t nextClient();
 public:
   WiFiServer();
   WiFiServer(uint16_t);
   WiFiClient available(uint8_t* status = NULL);
   WiFiClient accept();
+  /*
+   * Accept all pending connections at once
+   *
+   * param clients: array receiving the accepted clients
+   * param max: size of the clients array
+   * return: number of accepted clients
+   */
+  uint8_t acceptMany(WiFiClient clients[], uint8_t max);
+  // Pending connections found by the last acceptMany(), and the highest value seen
+  uint8_t acceptQueueDepth() { return _acceptDepth; }
+  uint8_t acceptQueuePeak() { return _acceptPeak; }
+  // True when the last acceptMany() filled its array, more connections may
+  // still be pending and acceptQueueDepth() is only a lower bound
+  bool acceptQueueFull() { return _acceptFull; }
   void begin();
   void begin(uint16_t port);
   void end();
+  // Close the accepted clients and open the listening socket again, after
+  // the NINA lost them because the connection to the access point was lost
+  void restart();
+
+  /*
+   * Serve all accepted clients round-robin from available(), instead of
+   * returning the last client for as long as it has data. Every call
+   * probes at most WIFI_SERVER_MAX_PROBES clients.
+   */
+  void setFairScheduling(bool fair) { _fair = fair; }
+
+  /*
+   * Close clients that have neither received nor sent data for timeout
+   * milliseconds. available() and accept() sweep for them periodically.
+   *
+   * param timeout: idle time before closing, 0 to keep clients forever
+   */
+  void setIdleTimeout(unsigned long timeout) { _idleTimeout = timeout; }
+  // Sweep for idle clients now, return the number of clients closed
+  uint8_t reapIdle();
+
   virtual size_t write(uint8_t);
   virtual size_t write(const uint8_t *buf, size_t size);
+  /*
+   * Send the same data to every client accepted by the server. Unlike
+   * write(), which has the NINA copy one transfer to all of its clients,
+   * the data crosses the bus once per client, but each client is checked.
+   * Clients that took only part of the data are closed.
+   *
+   * param results: optional array of WIFI_MAX_SOCK_NUM entries receiving the
+   *                number of bytes sent, indexed by socket number: size for
+   *                the clients the data was delivered to, less for the
+   *                clients closed, 0 when nothing was delivered
+   * return: number of clients the whole data was delivered to
+   */
+  uint8_t broadcast(const uint8_t *buf, size_t size, size_t results[] = NULL);
   uint8_t status();
   explicit operator bool();
 
@@ -0,0 +1,332 @@
+/*
+  WiFiSntpClient.cpp - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+
+#include "WiFiSntpClient.h"
+
+#define NTP_PORT 123
+#define NTP_PACKET_SIZE 48
+// Seconds from 1 Jan 1900 to 1 Jan 1970
+#define NTP_UNIX_OFFSET 2208988800UL
+
+#define NTP_MODE_CLIENT 3
+#define NTP_MODE_SERVER 4
+#define NTP_VERSION 4
+#define NTP_LI_UNSYNCHRONIZED 3
+
+static uint32_t readUint32(const uint8_t* p)
+{
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint64_t readUint64(const uint8_t* p)
+{
+  return ((uint64_t)readUint32(p) << 32) | readUint32(p + 4);
+}
+
+static void writeUint64(uint8_t* p, uint64_t value)
+{
+  for (int i = 7; i >= 0; i--) {
+    p[i] = value & 0xff;
+    value >>= 8;
+  }
+}
+
+// NTP timestamp to microseconds since the Unix epoch
+static int64_t ntpToMicros(const uint8_t* p)
+{
+  // the unsigned difference also holds after the 2036 era rollover
+  uint32_t seconds = readUint32(p) - NTP_UNIX_OFFSET;
+  uint32_t fraction = readUint32(p + 4);
+
+  return (int64_t)seconds * 1000000 + (int64_t)(((uint64_t)fraction * 1000000) >> 32);
+}
+
+WiFiSntpClient::WiFiSntpClient(WiFiUDP& udp, uint16_t localPort) :
+  _udp(udp),
+  _localPort(localPort),
+  _count(0),
+  _server(0),
+  _state(ST_STOPPED),
+  _synced(false),
+  _interval(WIFI_SNTP_DEFAULT_INTERVAL * 1000UL),
+  _nextRound(0),
+  _roundStart(0),
+  _sentAt(0),
+  _local(0),
+  _lastMicros(0),
+  _cookie(0),
+  _t1(0),
+  _lastEmpty(0),
+  _haveSample(false),
+  _sampleOffset(0),
+  _sampleDelay(0),
+  _offset(0),
+  _slewTarget(0),
+  _slewStart(0),
+  _lastOffset(0),
+  _lastDelay(0)
+{
+}
+
+bool WiFiSntpClient::addServer(const char* host)
+{
+  if (_count == WIFI_SNTP_MAX_SERVERS) {
+    return false;
+  }
+
+  _servers[_count++] = host;
+  return true;
+}
+
+bool WiFiSntpClient::begin()
+{
+  if (_count == 0 || !_udp.begin(_localPort)) {
+    return false;
+  }
+
+  _lastMicros = micros();
+  _state = ST_IDLE;
+  _nextRound = millis();
+  return true;
+}
+
+void WiFiSntpClient::end()
+{
+  // the clock keeps running from the last synchronization
+  _udp.stop();
+  _state = ST_STOPPED;
+}
+
+void WiFiSntpClient::update()
+{
+  _nextRound = millis();
+}
+
+void WiFiSntpClient::poll()
+{
+  // keep the 64 bit clock going even when nothing else happens
+  localMicros();
+
+  switch (_state) {
+    case ST_IDLE:
+      if ((long)(millis() - _nextRound) >= 0) {
+        _server = 0;
+        _haveSample = false;
+        _roundStart = millis();
+        _state = ST_SEND;
+      }
+      break;
+
+    case ST_SEND:
+      send();
+      break;
+
+    case ST_WAIT:
+      receive();
+      break;
+  }
+}
+
+uint64_t WiFiSntpClient::localMicros()
+{
+  unsigned long now = micros();
+
+  _local += (unsigned long)(now - _lastMicros);
+  _lastMicros = now;
+
+  return _local;
+}
+
+int64_t WiFiSntpClient::correction(uint64_t local)
+{
+  // part of the pending correction applied so far, at most WIFI_SNTP_MAX_SLEW_PPM
+  int64_t limit = (int64_t)((local - _slewStart) * WIFI_SNTP_MAX_SLEW_PPM / 1000000);
+
+  if (_slewTarget >= 0) {
+    return (_slewTarget < limit) ? _slewTarget : limit;
+  }
+  return (_slewTarget > -limit) ? _slewTarget : -limit;
+}
+
+void WiFiSntpClient::send()
+{
+  if (_server >= _count) {
+    finishRound();
+    return;
+  }
+
+  // drop replies that arrived too late for the previous request
+  while (_udp.parsePacket() > 0);
+
+  if (!_udp.beginPacket(_servers[_server], NTP_PORT)) {
+    _server++;
+    return;
+  }
+
+  uint8_t packet[NTP_PACKET_SIZE];
+
+  memset(packet, 0, sizeof(packet));
+  packet[0] = (NTP_VERSION << 3) | NTP_MODE_CLIENT;
+
+  // the server copies the transmit timestamp into the originate one of its
+  // reply, any unique value lets the reply be matched to this request
+  _cookie = localMicros();
+  writeUint64(packet + 40, _cookie);
+  _udp.write(packet, sizeof(packet));
+
+  // the request leaves during endPacket(), take the middle of the transfer
+  uint64_t before = localMicros();
+  int sent = _udp.endPacket();
+  uint64_t after = localMicros();
+
+  if (!sent) {
+    _server++;
+    return;
+  }
+
+  _t1 = before + (after - before) / 2;
+  _lastEmpty = after;
+  _sentAt = millis();
+  _state = ST_WAIT;
+}
+
+void WiFiSntpClient::receive()
+{
+  // checked first, so that stray or invalid datagrams can't keep the
+  // client waiting for a server that doesn't answer
+  if (millis() - _sentAt > WIFI_SNTP_TIMEOUT) {
+    _server++;
+    _state = ST_SEND;
+    return;
+  }
+
+  uint64_t start = localMicros();
+  int size = _udp.parsePacket();
+
+  if (size <= 0) {
+    _lastEmpty = localMicros();
+    return;
+  }
+
+  // the reply arrived between the previous empty check and this one
+  uint64_t t4 = _lastEmpty + (start - _lastEmpty) / 2;
+  uint8_t packet[NTP_PACKET_SIZE];
+  int received = 0;
+
+  if (size < NTP_PACKET_SIZE) {
+    return;
+  }
+
+  while (received < NTP_PACKET_SIZE) {
+    int result = _udp.read(packet + received, NTP_PACKET_SIZE - received);
+
+    if (result <= 0) {
+      return;
+    }
+    received += result;
+  }
+
+  uint8_t leap = packet[0] >> 6;
+  uint8_t mode = packet[0] & 0x07;
+  uint8_t stratum = packet[1];
+
+  if (mode != NTP_MODE_SERVER || leap == NTP_LI_UNSYNCHRONIZED ||
+      stratum == 0 || stratum > 15 || readUint64(packet + 24) != _cookie) {
+    // not a valid reply to the current request, keep waiting for it
+    return;
+  }
+
+  int64_t t1 = (int64_t)_t1;
+  int64_t t2 = ntpToMicros(packet + 32);
+  int64_t t3 = ntpToMicros(packet + 40);
+  int64_t offset = ((t2 - t1) + (t3 - (int64_t)t4)) / 2;
+  int64_t delay = ((int64_t)t4 - t1) - (t3 - t2);
+
+  if (delay < 0) {
+    delay = 0;
+  }
+
+  // the reply with the shortest round trip has the smallest error
+  if (!_haveSample || delay < _sampleDelay) {
+    _haveSample = true;
+    _sampleOffset = offset;
+    _sampleDelay = delay;
+  }
+
+  _server++;
+  _state = ST_SEND;
+}
+
+void WiFiSntpClient::finishRound()
+{
+  _state = ST_IDLE;
+
+  if (!_haveSample) {
+    _nextRound = millis() + WIFI_SNTP_RETRY_INTERVAL;
+    return;
+  }
+
+  uint64_t now = localMicros();
+
+  if (!_synced) {
+    _offset = _sampleOffset;
+    _slewTarget = 0;
+    _lastOffset = 0;
+    _synced = true;
+  } else {
+    int64_t current = _offset + correction(now);
+    int64_t difference = _sampleOffset - current;
+
+    if (difference > WIFI_SNTP_STEP_THRESHOLD) {
+      // far behind, moving forward at once keeps the clock monotonic
+      _offset = _sampleOffset;
+      _slewTarget = 0;
+    } else {
+      _offset = current;
+      _slewTarget = difference;
+    }
+    _lastOffset = (long)difference;
+  }
+  _slewStart = now;
+  _lastDelay = (unsigned long)_sampleDelay;
+  _nextRound = _roundStart + _interval;
+}
+
+uint64_t WiFiSntpClient::getEpochMicros()
+{
+  if (!_synced) {
+    return 0;
+  }
+
+  uint64_t now = localMicros();
+
+  return now + _offset + correction(now);
+}
+
+unsigned long WiFiSntpClient::getEpoch()
+{
+  return getEpochMicros() / 1000000;
+}
+
+unsigned long WiFiSntpClient::getMicros()
+{
+  return getEpochMicros() % 1000000;
+}
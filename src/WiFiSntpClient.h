@@ -0,0 +1,120 @@
+/*
+  WiFiSntpClient.h - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef wifisntpclient_h
+#define wifisntpclient_h
+
+#include "WiFi.h"
+#include "WiFiUdp.h"
+
+#define WIFI_SNTP_MAX_SERVERS 4
+#define WIFI_SNTP_LOCAL_PORT 2390
+// Time to wait for the reply of a server, in milliseconds
+#define WIFI_SNTP_TIMEOUT 1000
+// Time between two synchronizations, in seconds
+#define WIFI_SNTP_DEFAULT_INTERVAL 3600
+// Time before trying again when no server replied, in milliseconds
+#define WIFI_SNTP_RETRY_INTERVAL 15000
+// Fastest rate at which the clock is slewed, in parts per million
+#define WIFI_SNTP_MAX_SLEW_PPM 500
+// Corrections forward larger than this many microseconds step the clock
+#define WIFI_SNTP_STEP_THRESHOLD 1000000
+
+/*
+ * SNTP client working on top of a WiFiUDP.
+ *
+ * Each synchronization queries all the servers in turn and keeps the reply
+ * with the shortest round trip. The clock is then corrected slowly, so that
+ * it never goes backward. Call poll() from loop() to keep it synchronized.
+ */
+class WiFiSntpClient {
+public:
+  WiFiSntpClient(WiFiUDP& udp, uint16_t localPort = WIFI_SNTP_LOCAL_PORT);
+
+  // Add the host name of a server, the string must stay valid
+  // Returns true if successful, false if WIFI_SNTP_MAX_SERVERS are already set
+  bool addServer(const char* host);
+  void setInterval(unsigned long seconds) { _interval = seconds * 1000UL; }
+
+  bool begin();
+  void end();
+  void poll();
+  // Synchronize again at the next poll()
+  void update();
+
+  bool isSynchronized() { return _synced; }
+
+  // Current time since the Unix epoch, 0 when not synchronized
+  unsigned long getEpoch();
+  uint64_t getEpochMicros();
+  // Microseconds within the current second
+  unsigned long getMicros();
+
+  // Offset and round trip measured by the last synchronization, in microseconds
+  long lastOffset() { return _lastOffset; }
+  unsigned long lastDelay() { return _lastDelay; }
+
+private:
+  enum {
+    ST_STOPPED,
+    ST_IDLE,
+    ST_SEND,
+    ST_WAIT
+  };
+
+  uint64_t localMicros();
+  int64_t correction(uint64_t local);
+  void send();
+  void receive();
+  void finishRound();
+
+  WiFiUDP& _udp;
+  uint16_t _localPort;
+  const char* _servers[WIFI_SNTP_MAX_SERVERS];
+  uint8_t _count;
+  uint8_t _server;
+  uint8_t _state;
+  bool _synced;
+  unsigned long _interval;
+  unsigned long _nextRound;
+  unsigned long _roundStart;
+  unsigned long _sentAt;
+
+  // local clock, extending micros() to 64 bits
+  uint64_t _local;
+  unsigned long _lastMicros;
+
+  uint64_t _cookie;
+  uint64_t _t1;
+  uint64_t _lastEmpty;
+
+  bool _haveSample;
+  int64_t _sampleOffset;
+  int64_t _sampleDelay;
+
+  // server time = local time + offset + slewed part of slewTarget
+  int64_t _offset;
+  int64_t _slewTarget;
+  uint64_t _slewStart;
+
+  long _lastOffset;
+  unsigned long _lastDelay;
+};
+
+#endif
@@ -27,4 +27,42 @@ WiFiStorageFile WiFiStorageClass::open(const char *filename) {
 
 WiFiStorageFile WiFiStorageClass::open(String filename) {
 	return open(filename.c_str());
-}
\ No newline at end of file
+}
+
+uint32_t WiFiStorageClass::sendFile(Client& client, WiFiStorageFile& file, uint32_t offset, uint32_t len) {
+	uint8_t buffer[WIFI_STORAGE_SEND_BUFFER_SIZE];
+	uint32_t size = file.size();
+	uint32_t sent = 0;
+
+	if (offset >= size) {
+		return 0;
+	}
+	if (len > size - offset) {
+		len = size - offset;
+	}
+
+	file.seek(offset);
+	while (sent < len) {
+		// fill the buffer with several reads, then send it at once
+		uint32_t count = 0;
+		while (count < sizeof(buffer) && sent + count < len) {
+			uint32_t n = sizeof(buffer) - count;
+			if (n > WIFI_STORAGE_MAX_READ) {
+				n = WIFI_STORAGE_MAX_READ;
+			}
+			if (n > len - sent - count) {
+				n = len - sent - count;
+			}
+			n = file.read(&buffer[count], n);
+			if (n == 0) {
+				break;
+			}
+			count += n;
+		}
+		if (count == 0 || client.write(buffer, count) != count) {
+			break;
+		}
+		sent += count;
+	}
+	return sent;
+}
@@ -22,6 +22,15 @@
 
 #include "utility/wifi_drv.h"
 
+// Largest block returned by a single READ_FILE request
+#define WIFI_STORAGE_MAX_READ 255
+
+#ifdef __AVR__
+#define WIFI_STORAGE_SEND_BUFFER_SIZE 64
+#else
+#define WIFI_STORAGE_SEND_BUFFER_SIZE (4 * WIFI_STORAGE_MAX_READ)
+#endif
+
 class WiFiStorageFile;
 
 class WiFiStorageClass
@@ -74,6 +83,15 @@ public:
     }
 
 
+	/*
+	 * Send the content of a file to a client
+	 *
+	 * param offset: position of the first byte to send
+	 * param len: number of bytes to send, the rest of the file by default
+	 * return: number of bytes sent
+	 */
+	static uint32_t sendFile(Client& client, WiFiStorageFile& file, uint32_t offset = 0, uint32_t len = 0xFFFFFFFF);
+
     static bool remove(String filename) {
     	return remove(filename.c_str());
 	}
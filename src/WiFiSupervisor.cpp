@@ -0,0 +1,219 @@
+/*
+  WiFiSupervisor.cpp - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include "WiFiSupervisor.h"
+
+WiFiSupervisor::WiFiSupervisor(const char* ssid, const char* passphrase) :
+  _ssid(ssid),
+  _passphrase(passphrase),
+  _serverCount(0),
+  _udpCount(0),
+  _state(ST_STOPPED),
+  _wasConnected(false),
+  _minDelay(WIFI_SUPERVISOR_MIN_BACKOFF),
+  _maxDelay(WIFI_SUPERVISOR_MAX_BACKOFF),
+  _attemptStart(0),
+  _lastCheck(0),
+  _nextAttempt(0),
+  _connectedAt(0),
+  _reconnects(0),
+  _failures(0),
+  _seed(1)
+{
+}
+
+bool WiFiSupervisor::addServer(WiFiServer& server)
+{
+  if (_serverCount == WIFI_SUPERVISOR_MAX_SERVERS) {
+    return false;
+  }
+
+  _servers[_serverCount++] = &server;
+  return true;
+}
+
+bool WiFiSupervisor::addUDP(WiFiUDP& udp)
+{
+  if (_udpCount == WIFI_SUPERVISOR_MAX_UDP) {
+    return false;
+  }
+
+  _udps[_udpCount++] = &udp;
+  return true;
+}
+
+void WiFiSupervisor::setBackoff(unsigned long minDelay, unsigned long maxDelay)
+{
+  _minDelay = minDelay ? minDelay : 1;
+  _maxDelay = (maxDelay > _minDelay) ? maxDelay : _minDelay;
+}
+
+void WiFiSupervisor::begin()
+{
+  uint8_t mac[WL_MAC_ADDR_LENGTH];
+
+  // boards started at the same time must still wait for different times,
+  // mix their MAC address into the seed of the jitter
+  WiFi.macAddress(mac);
+  _seed = micros();
+  for (uint8_t i = 0; i < WL_MAC_ADDR_LENGTH; i++) {
+    _seed = _seed * 31 + mac[i];
+  }
+  if (_seed == 0) {
+    _seed = 1;
+  }
+
+  _failures = 0;
+  _wasConnected = false;
+
+  if (WiFi.status() == WL_CONNECTED) {
+    // connected by the sketch
+    linkUp(false);
+  } else {
+    connect();
+  }
+}
+
+void WiFiSupervisor::end()
+{
+  // the connection is left as it is
+  _state = ST_STOPPED;
+}
+
+void WiFiSupervisor::poll()
+{
+  if (_state == ST_STOPPED) {
+    return;
+  }
+
+  if (_state == ST_BACKOFF) {
+    if ((long)(millis() - _nextAttempt) >= 0) {
+      connect();
+    }
+    return;
+  }
+
+  // a single status request per interval, however often poll() is called
+  if (millis() - _lastCheck < WIFI_LINK_CHECK_INTERVAL) {
+    return;
+  }
+  _lastCheck = millis();
+
+  uint8_t status = WiFi.status();
+
+  if (_state == ST_CONNECTED) {
+    if (status != WL_CONNECTED) {
+      // wait even before the first attempt, all the boards served by the
+      // access point lost it at the same time
+      retry();
+    }
+  } else if (status == WL_CONNECTED) {
+    linkUp(_wasConnected);
+  } else if (status == WL_CONNECT_FAILED || millis() - _attemptStart >= WIFI_SUPERVISOR_CONNECT_TIMEOUT) {
+    _failures++;
+    retry();
+  }
+}
+
+unsigned long WiFiSupervisor::uptime()
+{
+  if (_state != ST_CONNECTED) {
+    return 0;
+  }
+
+  return millis() - _connectedAt;
+}
+
+void WiFiSupervisor::connect()
+{
+  int result;
+
+  if (_passphrase) {
+    result = WiFi.beginAsync(_ssid, _passphrase);
+  } else {
+    result = WiFi.beginAsync(_ssid);
+  }
+
+  _attemptStart = _lastCheck = millis();
+
+  if (result == WL_CONNECT_FAILED) {
+    _failures++;
+    retry();
+  } else {
+    _state = ST_CONNECTING;
+  }
+}
+
+void WiFiSupervisor::linkUp(bool reconnection)
+{
+  _state = ST_CONNECTED;
+  _connectedAt = millis();
+  _failures = 0;
+
+  if (reconnection) {
+    _reconnects++;
+
+    // the NINA drops its sockets with the connection, open them again
+    // unless the sketch closed them on purpose
+    for (uint8_t i = 0; i < _serverCount; i++) {
+      if (*_servers[i]) {
+        _servers[i]->restart();
+      }
+    }
+    for (uint8_t i = 0; i < _udpCount; i++) {
+      _udps[i]->restart();
+    }
+  } else {
+    for (uint8_t i = 0; i < _serverCount; i++) {
+      _servers[i]->begin();
+    }
+  }
+  _wasConnected = true;
+}
+
+void WiFiSupervisor::retry()
+{
+  // keep the module from joining on its own while waiting
+  WiFi.disconnect();
+
+  unsigned long wait = _minDelay;
+
+  for (unsigned long i = 0; i < _failures && wait < _maxDelay; i++) {
+    wait *= 2;
+  }
+  if (wait > _maxDelay) {
+    wait = _maxDelay;
+  }
+
+  // anywhere between half and all of the wait
+  wait = wait / 2 + jitter() % (wait - wait / 2 + 1);
+
+  _nextAttempt = millis() + wait;
+  _state = ST_BACKOFF;
+}
+
+uint32_t WiFiSupervisor::jitter()
+{
+  // xorshift, independent of the random() sequence of the sketch
+  _seed ^= _seed << 13;
+  _seed ^= _seed >> 17;
+  _seed ^= _seed << 5;
+
+  return _seed;
+}
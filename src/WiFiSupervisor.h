@@ -0,0 +1,107 @@
+/*
+  WiFiSupervisor.h - Library for Arduino boards based on NINA WiFi module.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef wifisupervisor_h
+#define wifisupervisor_h
+
+#include "WiFi.h"
+#include "WiFiServer.h"
+#include "WiFiUdp.h"
+
+#ifdef __AVR__
+#define WIFI_SUPERVISOR_MAX_SERVERS 2
+#define WIFI_SUPERVISOR_MAX_UDP 2
+#else
+#define WIFI_SUPERVISOR_MAX_SERVERS 4
+#define WIFI_SUPERVISOR_MAX_UDP 4
+#endif
+// Time given to a connection attempt before it is considered failed, in milliseconds
+#define WIFI_SUPERVISOR_CONNECT_TIMEOUT 15000
+// Default shortest and longest wait between two connection attempts, in milliseconds
+#define WIFI_SUPERVISOR_MIN_BACKOFF 1000
+#define WIFI_SUPERVISOR_MAX_BACKOFF 120000
+
+/*
+ * Keeps the board connected to an access point.
+ *
+ * The link is checked every WIFI_LINK_CHECK_INTERVAL milliseconds. When it
+ * is lost, the supervisor connects again, waiting twice as long after each
+ * failed attempt. Every wait is randomized between half and all of its
+ * length, so that boards that lost the same access point don't all come
+ * back at once. The servers added to the supervisor are started once the
+ * first connection is made. After each reconnection, they are restarted,
+ * closing the clients lost with the connection, and the UDP objects
+ * started with begin() or beginMulticast() are opened again. Call poll()
+ * from loop().
+ */
+class WiFiSupervisor {
+public:
+  // The strings must stay valid, passphrase is NULL for an open network
+  WiFiSupervisor(const char* ssid, const char* passphrase = NULL);
+
+  // Returns true if successful, false if the maximum is already reached
+  bool addServer(WiFiServer& server);
+  bool addUDP(WiFiUDP& udp);
+  void setBackoff(unsigned long minDelay, unsigned long maxDelay);
+
+  void begin();
+  void end();
+  void poll();
+
+  bool connected() { return _state == ST_CONNECTED; }
+  // Time since the connection was established, 0 when not connected, in milliseconds
+  unsigned long uptime();
+  // Number of times the connection was established again after being lost
+  unsigned long reconnects() { return _reconnects; }
+  // Connection attempts that failed since the connection was lost
+  unsigned long failures() { return _failures; }
+
+private:
+  enum {
+    ST_STOPPED,
+    ST_CONNECTING,
+    ST_CONNECTED,
+    ST_BACKOFF
+  };
+
+  void connect();
+  void linkUp(bool reconnection);
+  void retry();
+  uint32_t jitter();
+
+  const char* _ssid;
+  const char* _passphrase;
+  WiFiServer* _servers[WIFI_SUPERVISOR_MAX_SERVERS];
+  uint8_t _serverCount;
+  WiFiUDP* _udps[WIFI_SUPERVISOR_MAX_UDP];
+  uint8_t _udpCount;
+  uint8_t _state;
+  bool _wasConnected;
+  unsigned long _minDelay;
+  unsigned long _maxDelay;
+  unsigned long _attemptStart;
+  unsigned long _lastCheck;
+  unsigned long _nextAttempt;
+  unsigned long _connectedAt;
+  unsigned long _reconnects;
+  unsigned long _failures;
+  uint32_t _seed;
+};
+
+#endif
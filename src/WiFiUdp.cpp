@@ -18,6 +18,7 @@
   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
+#include <stdlib.h>
 #include <string.h>
 
 extern "C" {
@@ -28,6 +29,7 @@ extern "C" {
 #include "utility/server_drv.h"
 #include "utility/wifi_drv.h"
 #include "utility/WiFiSocketBuffer.h"
+#include "utility/WiFiDnsCache.h"
 
 #include "WiFi.h"
 #include "WiFiUdp.h"
@@ -36,7 +38,27 @@ extern "C" {
 
 
 /* Constructor */
-WiFiUDP::WiFiUDP() : _sock(NO_SOCKET_AVAIL), _parsed(0) {}
+WiFiUDP::WiFiUDP() :
+  _sock(NO_SOCKET_AVAIL),
+  _port(0),
+  _listening(false),
+  _parsed(0),
+  _txIp(0),
+  _txPort(0),
+  _txStarted(false),
+  _txLen(0),
+  _txBuffer(NULL),
+  _remoteIp(0),
+  _remotePort(0),
+  _remoteValid(false),
+  _multicastIp(0)
+{
+}
+
+WiFiUDP::~WiFiUDP()
+{
+  free(_txBuffer);
+}
 
 /* Start WiFiUDP socket, listening at local port PORT */
 uint8_t WiFiUDP::begin(uint16_t port) {
@@ -51,7 +73,10 @@ uint8_t WiFiUDP::begin(uint16_t port) {
         ServerDrv::startServer(port, sock, UDP_MODE);
         _sock = sock;
         _port = port;
+        _multicastIp = 0;
         _parsed = 0;
+        _remoteValid = false;
+        _listening = true;
         return 1;
     }
     return 0;
@@ -66,10 +91,18 @@ uint8_t WiFiUDP::beginMulticast(IPAddress ip, uint16_t port) {
     uint8_t sock = ServerDrv::getSocket();
     if (sock != NO_SOCKET_AVAIL)
     {
-        ServerDrv::startServer(ip, port, sock, UDP_MULTICAST_MODE);
+        if (!ServerDrv::startServer(ip, port, sock, UDP_MULTICAST_MODE))
+        {
+            // release the socket the NINA couldn't bind to the group
+            ServerDrv::stopClient(sock);
+            return 0;
+        }
         _sock = sock;
         _port = port;
+        _multicastIp = ip;
         _parsed = 0;
+        _remoteValid = false;
+        _listening = true;
         return 1;
     }
     return 0;
@@ -91,18 +124,38 @@ void WiFiUDP::stop()
 
 	  WiFiSocketBuffer.close(_sock);
 	  _sock = NO_SOCKET_AVAIL;
+	  _listening = false;
+	  _multicastIp = 0;
+	  _parsed = 0;
+
+	  free(_txBuffer);
+	  _txBuffer = NULL;
+	  _txLen = 0;
+	  _txStarted = false;
 }
 
 int WiFiUDP::beginPacket(const char *host, uint16_t port)
 {
-	// Look up the host first
-	int ret = 0;
-	IPAddress remote_addr;
-	if (WiFi.hostByName(host, remote_addr))
-	{
-		return beginPacket(remote_addr, port);
-	}
-	return ret;
+  if (WiFiDnsCache.enabled())
+  {
+	  // an address already known saves the lookup on the NINA
+	  IPAddress remote_addr;
+	  if (WiFi.hostByName(host, remote_addr) != 1)
+	    return 0;
+	  return beginPacket(remote_addr, port);
+  }
+
+  if (_sock == NO_SOCKET_AVAIL)
+	  _sock = ServerDrv::getSocket();
+  if (_sock != NO_SOCKET_AVAIL)
+  {
+	  // the host is resolved by the NINA when the packet is started
+	  ServerDrv::startClient(host, strlen(host), uint32_t(0), port, _sock, UDP_MODE);
+	  _txStarted = true;
+	  _txLen = 0;
+	  return 1;
+  }
+  return 0;
 }
 
 int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
@@ -111,15 +164,43 @@ int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
 	  _sock = ServerDrv::getSocket();
   if (_sock != NO_SOCKET_AVAIL)
   {
-	  ServerDrv::startClient(uint32_t(ip), port, _sock, UDP_MODE);
+	  // the packet is started on the NINA once its data is ready
+	  _txIp = ip;
+	  _txPort = port;
+	  _txStarted = false;
+	  _txLen = 0;
 	  return 1;
   }
   return 0;
 }
 
+bool WiFiUDP::flushTx()
+{
+  if (!_txStarted)
+  {
+	  ServerDrv::startClient(_txIp, _txPort, _sock, UDP_MODE);
+	  _txStarted = true;
+  }
+  if (_txLen == 0)
+  {
+	  return true;
+  }
+
+  uint16_t len = _txLen;
+
+  _txLen = 0;
+  return ServerDrv::insertDataBuf(_sock, _txBuffer, len);
+}
+
 int WiFiUDP::endPacket()
 {
-	return ServerDrv::sendUdpData(_sock);
+	if (_sock == NO_SOCKET_AVAIL)
+	  return 0;
+
+	bool inserted = flushTx();
+
+	_txStarted = false;
+	return ServerDrv::sendUdpData(_sock) && inserted;
 }
 
 size_t WiFiUDP::write(uint8_t byte)
@@ -129,23 +210,191 @@ size_t WiFiUDP::write(uint8_t byte)
 
 size_t WiFiUDP::write(const uint8_t *buffer, size_t size)
 {
-	ServerDrv::insertDataBuf(_sock, buffer, size);
-	return size;
+	if (_sock == NO_SOCKET_AVAIL)
+	  return 0;
+
+	if (_txBuffer == NULL)
+	  _txBuffer = (uint8_t*)malloc(WIFI_UDP_TX_BUFFER_SIZE);
+
+	if (_txBuffer == NULL)
+	{
+	  // no memory to collect the packet, hand the data to the NINA right away
+	  if (size > WIFI_UDP_MAX_PACKET_SIZE)
+	    return 0;
+	  flushTx();
+	  ServerDrv::insertDataBuf(_sock, buffer, size);
+	  return size;
+	}
+
+	size_t written = 0;
+
+	while (written < size)
+	{
+	  if (_txLen == WIFI_UDP_TX_BUFFER_SIZE && !flushTx())
+	    break;
+
+	  size_t chunk = size - written;
+
+	  if (chunk > (size_t)(WIFI_UDP_TX_BUFFER_SIZE - _txLen))
+	    chunk = WIFI_UDP_TX_BUFFER_SIZE - _txLen;
+
+	  memcpy(_txBuffer + _txLen, buffer + written, chunk);
+	  _txLen += chunk;
+	  written += chunk;
+	}
+	return written;
+}
+
+int WiFiUDP::sendTo(IPAddress ip, uint16_t port, const uint8_t *buffer, size_t size)
+{
+  // larger data doesn't fit in a datagram, don't send a truncated one
+  if (size > WIFI_UDP_MAX_PACKET_SIZE)
+	  return 0;
+
+  if (_sock == NO_SOCKET_AVAIL)
+	  _sock = ServerDrv::getSocket();
+  if (_sock == NO_SOCKET_AVAIL)
+	  return 0;
+
+  // the data goes straight from the caller's buffer, a packet being built is dropped
+  _txLen = 0;
+  _txStarted = false;
+
+  ServerDrv::startClient(uint32_t(ip), port, _sock, UDP_MODE);
+  if (size && !ServerDrv::insertDataBuf(_sock, buffer, size))
+	  return 0;
+
+  return ServerDrv::sendUdpData(_sock);
+}
+
+void WiFiUDP::discardPacket()
+{
+	skip(_parsed);
+	_parsed = 0;
+}
+
+uint8_t WiFiUDP::sendBatch(const WiFiUDPDatagram datagrams[], uint8_t count, uint8_t status[])
+{
+  uint8_t sent = 0;
+
+  for (uint8_t i = 0; i < count; i++)
+  {
+	  const WiFiUDPDatagram& datagram = datagrams[i];
+	  int result = sendTo(datagram.remoteIP, datagram.remotePort, datagram.data, datagram.length);
+
+	  if (status)
+	    status[i] = result;
+	  if (result)
+	    sent++;
+  }
+  return sent;
+}
+
+int WiFiUDP::joinGroup(IPAddress group)
+{
+  if (!_listening)
+	  return 0;
+  if (uint32_t(group) == _multicastIp)
+	  return 1;
+
+  // the NINA joins a single group per socket, and can't bind a second
+  // socket to the port for another one
+  if (_multicastIp)
+	  return 0;
+
+  // open the group's socket in place of the unicast one, it is bound to
+  // every address and still receives the packets sent to the port
+  uint16_t port = _port;
+  if (beginMulticast(group, port))
+	  return 1;
+
+  begin(port);
+  return 0;
+}
+
+int WiFiUDP::leaveGroup(IPAddress group)
+{
+  if (!_listening || uint32_t(group) != _multicastIp)
+	  return 0;
+
+  return begin(_port);
+}
+
+uint8_t WiFiUDP::restart()
+{
+  // a socket opened by beginPacket() or sendTo() has no port to listen on
+  if (!_listening)
+	  return 0;
+
+  // stop() forgets the settings, keep them for the new socket
+  uint16_t port = _port;
+  uint32_t multicastIp = _multicastIp;
+
+  return multicastIp ? beginMulticast(multicastIp, port) : begin(port);
 }
 
 int WiFiUDP::parsePacket()
 {
-	while (_parsed--)
+	// discard previously parsed packet data
+	discardPacket();
+
+	_parsed = ServerDrv::availData(_sock);
+	_remoteValid = false;
+
+	return _parsed;
+}
+
+int WiFiUDP::parsePacket(IPAddress& ip, uint16_t& port, uint8_t* buffer, size_t len, size_t* received)
+{
+	int size = parsePacket();
+	size_t copied = 0;
+
+	if (size > 0)
 	{
-	  // discard previously parsed packet data
-	  uint8_t b;
+	  fetchRemote();
+	  ip = _remoteIp;
+	  port = _remotePort;
+
+	  // a packet larger than the socket buffer takes several refills
+	  while (copied < len && _parsed > 0)
+	  {
+	    int result = read(buffer + copied, len - copied);
+
+	    if (result <= 0)
+	      break;
+	    copied += result;
+	  }
+	}
+	if (received)
+	  *received = copied;
+	return size;
+}
+
+uint8_t WiFiUDP::receiveBatch(WiFiUDPPacket packets[], uint8_t max, uint8_t* arena, size_t arenaLen)
+{
+	uint8_t count = 0;
+	size_t used = 0;
 
-	  WiFiSocketBuffer.read(_sock, &b, sizeof(b));
+	while (count < max && used < arenaLen)
+	{
+	  WiFiUDPPacket& packet = packets[count];
+	  size_t received;
+	  int size = parsePacket(packet.remoteIP, packet.remotePort, arena + used, arenaLen - used, &received);
+
+	  if (size <= 0)
+	    break;
+
+	  packet.data = arena + used;
+	  packet.size = size;
+	  packet.length = received;
+	  used += packet.length;
+	  count++;
 	}
 
-	_parsed = ServerDrv::availData(_sock);
+	// what didn't fit in the arena is not kept for read()
+	discardPacket();
 
-	return _parsed;
+	return count;
 }
 
 int WiFiUDP::read()
@@ -190,28 +439,76 @@ int WiFiUDP::peek()
   return WiFiSocketBuffer.peek(_sock);
 }
 
+int WiFiUDP::view(const uint8_t** data)
+{
+  if (_parsed < 1)
+  {
+    return 0;
+  }
+
+  int avail = WiFiSocketBuffer.view(_sock, data);
+
+  if (avail > _parsed)
+  {
+    avail = _parsed;
+  }
+
+  return avail;
+}
+
+void WiFiUDP::skip(size_t len)
+{
+  const uint8_t* data;
+
+  while (len && _parsed > 0)
+  {
+    int avail = view(&data);
+
+    if (avail <= 0)
+    {
+      break;
+    }
+    if ((size_t)avail > len)
+    {
+      avail = len;
+    }
+
+    WiFiSocketBuffer.skip(_sock, avail);
+    _parsed -= avail;
+    len -= avail;
+  }
+}
+
 void WiFiUDP::flush()
 {
   // TODO: a real check to ensure transmission has been completed
 }
 
-IPAddress  WiFiUDP::remoteIP()
+void WiFiUDP::fetchRemote()
 {
-	uint8_t _remoteIp[4] = {0};
-	uint8_t _remotePort[2] = {0};
+	// the sender is the same for the whole packet, ask the NINA only once
+	if (_remoteValid)
+	  return;
 
-	WiFiDrv::getRemoteData(_sock, _remoteIp, _remotePort);
-	IPAddress ip(_remoteIp);
-	return ip;
+	uint8_t remoteIp[4] = {0};
+	uint8_t remotePort[2] = {0};
+
+	WiFiDrv::getRemoteData(_sock, remoteIp, remotePort);
+	_remoteIp = IPAddress(remoteIp);
+	_remotePort = (remotePort[0]<<8)+remotePort[1];
+	_remoteValid = true;
 }
 
-uint16_t  WiFiUDP::remotePort()
+IPAddress  WiFiUDP::remoteIP()
 {
-	uint8_t _remoteIp[4] = {0};
-	uint8_t _remotePort[2] = {0};
+	fetchRemote();
+	return IPAddress(_remoteIp);
+}
 
-	WiFiDrv::getRemoteData(_sock, _remoteIp, _remotePort);
-	uint16_t port = (_remotePort[0]<<8)+_remotePort[1];
-	return port;
+uint16_t  WiFiUDP::remotePort()
+{
+	fetchRemote();
+	return _remotePort;
 }
 
+
@@ -25,25 +25,98 @@
 
 #define UDP_TX_PACKET_MAX_SIZE 24
 
+// Size of the buffer collecting the data written between beginPacket() and endPacket()
+#ifdef __AVR__
+#define WIFI_UDP_TX_BUFFER_SIZE 64
+#else
+#define WIFI_UDP_TX_BUFFER_SIZE 1472
+#endif
+
+// Largest payload of a UDP datagram over IPv4
+#define WIFI_UDP_MAX_PACKET_SIZE 65507
+
+/*
+ * Packet received by WiFiUDP::receiveBatch().
+ *
+ * data points into the arena given to receiveBatch(), length is the number
+ * of bytes stored there and size the size of the packet, larger than length
+ * when the arena was too small for the whole packet.
+ */
+struct WiFiUDPPacket {
+  IPAddress remoteIP;
+  uint16_t remotePort;
+  uint8_t* data;
+  uint16_t length;
+  uint16_t size;
+};
+
+/*
+ * Packet sent by WiFiUDP::sendBatch().
+ */
+struct WiFiUDPDatagram {
+  IPAddress remoteIP;
+  uint16_t remotePort;
+  const uint8_t* data;
+  uint16_t length;
+};
+
 class WiFiUDP : public UDP {
 private:
   uint8_t _sock;  // socket ID for Wiz5100
   uint16_t _port; // local port to listen on
+  bool _listening; // begin() or beginMulticast() was called
   int _parsed;
+  uint32_t _txIp;
+  uint16_t _txPort;
+  bool _txStarted;
+  uint16_t _txLen;
+  uint8_t* _txBuffer;
+  uint32_t _remoteIp;
+  uint16_t _remotePort;
+  bool _remoteValid;
+  uint32_t _multicastIp; // group joined by beginMulticast() or joinGroup()
+
+  bool flushTx();
+  void discardPacket();
+  void fetchRemote();
+
+  // the transmit buffer belongs to a single object
+  WiFiUDP(const WiFiUDP&) = delete;
+  WiFiUDP& operator=(const WiFiUDP&) = delete;
 
 public:
   WiFiUDP();  // Constructor
+  ~WiFiUDP();
   virtual uint8_t begin(uint16_t);	// initialize, start listening on specified port. Returns 1 if successful, 0 if there are no sockets available to use
   virtual uint8_t beginMulticast(IPAddress, uint16_t);  // initialize, start listening on specified multicast IP address and port. Returns 1 if successful, 0 if there are no sockets available to use
   virtual void stop();  // Finish with the UDP socket
 
+  // Also receive the packets sent to the multicast group on the local port
+  // The NINA joins a single group per socket and can't bind a second socket to
+  // the port, so a WiFiUDP started with begin() reopens its socket for the group
+  // and one group can be joined at a time
+  // Returns 1 if successful, 0 if begin() wasn't called, another group is joined
+  // or the NINA couldn't bind the socket to the group
+  int joinGroup(IPAddress group);
+  // Stop receiving the packets of the group, keep listening on the local port
+  // Returns 1 if successful, 0 if the group wasn't joined
+  int leaveGroup(IPAddress group);
+  // Open the socket again with the same port and group, after the NINA
+  // lost it because the connection to the access point was lost
+  // Returns 1 if successful, 0 if neither begin() nor beginMulticast() was called,
+  // or the socket couldn't be opened again
+  uint8_t restart();
+
   // Sending UDP packets
   
   // Start building up a packet to send to the remote host specific in ip and port
+  // The packet is collected locally and handed to the NINA by endPacket()
   // Returns 1 if successful, 0 if there was a problem with the supplied IP address or port
   virtual int beginPacket(IPAddress ip, uint16_t port);
   // Start building up a packet to send to the remote host specific in host and port
-  // Returns 1 if successful, 0 if there was a problem resolving the hostname or port
+  // The hostname is resolved by the NINA together with the request, so an unknown host
+  // is reported by endPacket() rather than here, unless the DNS cache is enabled
+  // Returns 1 if successful, 0 if there are no sockets available to use
   virtual int beginPacket(const char *host, uint16_t port);
   // Finish off this packet and send it
   // Returns 1 if the packet was sent successfully, 0 if there was an error
@@ -52,12 +125,29 @@ public:
   virtual size_t write(uint8_t);
   // Write size bytes from buffer into the packet
   virtual size_t write(const uint8_t *buffer, size_t size);
+  // Send size bytes from buffer as a single packet to the remote host at ip and port
+  // Returns 1 if the packet was sent successfully, 0 if there was an error or size
+  // is larger than WIFI_UDP_MAX_PACKET_SIZE
+  int sendTo(IPAddress ip, uint16_t port, const uint8_t *buffer, size_t size);
+  // Send count packets, each to its own remote host, status receives 1 for
+  // every packet sent successfully and 0 otherwise when not NULL
+  // Returns the number of packets sent successfully
+  uint8_t sendBatch(const WiFiUDPDatagram datagrams[], uint8_t count, uint8_t status[] = NULL);
   
   using Print::write;
 
   // Start processing the next available incoming packet
   // Returns the size of the packet in bytes, or 0 if no packets are available
   virtual int parsePacket();
+  // Start processing the next available incoming packet, report its sender
+  // and read up to len bytes of it into buffer, the rest is left for read()
+  // received, when not NULL, is set to the number of bytes stored in buffer
+  // Returns the size of the packet in bytes, or 0 if no packets are available
+  int parsePacket(IPAddress& ip, uint16_t& port, uint8_t* buffer, size_t len, size_t* received = NULL);
+  // Receive up to max queued packets, storing their payload one after the
+  // other in arena. Stops early when no packet is left or arena is full
+  // Returns the number of packets received
+  uint8_t receiveBatch(WiFiUDPPacket packets[], uint8_t max, uint8_t* arena, size_t arenaLen);
   // Number of bytes remaining in the current packet
   virtual int available();
   // Read a single byte from the current packet
@@ -70,6 +160,13 @@ public:
   virtual int read(char* buffer, size_t len) { return read((unsigned char*)buffer, len); };
   // Return the next byte from the current packet without moving on to the next byte
   virtual int peek();
+  // Point data to the unread bytes of the current packet held in the socket buffer,
+  // valid until the next read(), skip() or parsePacket() call. Packets larger than
+  // the socket buffer are seen a part at a time, use skip() to move to the next one
+  // Returns the number of bytes data points to, or 0 if none are available
+  int view(const uint8_t** data);
+  // Move on by len bytes in the current packet without copying them
+  void skip(size_t len);
   virtual void flush();	// Finish reading the current packet
 
   // Return the IP address of the host who sent the current incoming packet
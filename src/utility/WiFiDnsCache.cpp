@@ -0,0 +1,143 @@
+/*
+  This file is part of the WiFiNINA library.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "Arduino.h"
+
+#include "WiFiDnsCache.h"
+
+WiFiDnsCacheClass::WiFiDnsCacheClass() :
+  _entries(NULL),
+  _capacity(0),
+  _lifetime(0),
+  _clock(0),
+  _hits(0),
+  _misses(0)
+{
+}
+
+WiFiDnsCacheClass::~WiFiDnsCacheClass()
+{
+  end();
+}
+
+bool WiFiDnsCacheClass::begin(uint8_t capacity, unsigned long lifetime)
+{
+  end();
+
+  if (capacity == 0) {
+    return false;
+  }
+
+  _entries = (Entry*)malloc(capacity * sizeof(Entry));
+  if (_entries == NULL) {
+    return false;
+  }
+
+  _capacity = capacity;
+  _lifetime = lifetime;
+  clear();
+  return true;
+}
+
+void WiFiDnsCacheClass::end()
+{
+  free(_entries);
+  _entries = NULL;
+  _capacity = 0;
+}
+
+void WiFiDnsCacheClass::clear()
+{
+  for (uint8_t i = 0; i < _capacity; i++) {
+    _entries[i].name[0] = '\0';
+  }
+  _hits = 0;
+  _misses = 0;
+}
+
+WiFiDnsCacheClass::Entry* WiFiDnsCacheClass::find(const char* name)
+{
+  for (uint8_t i = 0; i < _capacity; i++) {
+    Entry& entry = _entries[i];
+
+    // host names are case insensitive
+    if (entry.name[0] && strcasecmp(entry.name, name) == 0) {
+      return &entry;
+    }
+  }
+  return NULL;
+}
+
+bool WiFiDnsCacheClass::lookup(const char* name, IPAddress& result)
+{
+  Entry* entry = find(name);
+
+  if (entry && (millis() - entry->stored) >= _lifetime) {
+    // expired, free the slot for the new answer
+    entry->name[0] = '\0';
+    entry = NULL;
+  }
+
+  if (entry == NULL) {
+    _misses++;
+    return false;
+  }
+
+  entry->used = ++_clock;
+  result = entry->address;
+  _hits++;
+  return true;
+}
+
+void WiFiDnsCacheClass::store(const char* name, IPAddress address)
+{
+  if (strlen(name) >= WIFI_DNS_CACHE_MAX_NAME) {
+    return;
+  }
+
+  Entry* entry = find(name);
+
+  if (entry == NULL) {
+    // take a free slot, or else the least recently used one
+    for (uint8_t i = 0; i < _capacity; i++) {
+      Entry& candidate = _entries[i];
+
+      if (candidate.name[0] == '\0') {
+        entry = &candidate;
+        break;
+      }
+      if (entry == NULL || (_clock - candidate.used) > (_clock - entry->used)) {
+        entry = &candidate;
+      }
+    }
+    if (entry == NULL) {
+      return;
+    }
+    strcpy(entry->name, name);
+  }
+
+  entry->address = address;
+  entry->stored = millis();
+  entry->used = ++_clock;
+}
+
+WiFiDnsCacheClass WiFiDnsCache;
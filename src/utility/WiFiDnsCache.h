@@ -0,0 +1,73 @@
+/*
+  This file is part of the WiFiNINA library.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef WiFiDnsCache_h
+#define WiFiDnsCache_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IPAddress.h"
+
+// Longest host name that is cached, including the terminator
+#ifdef __AVR__
+#define WIFI_DNS_CACHE_MAX_NAME 32
+#else
+#define WIFI_DNS_CACHE_MAX_NAME 64
+#endif
+
+class WiFiDnsCacheClass {
+
+public:
+  WiFiDnsCacheClass();
+  ~WiFiDnsCacheClass();
+
+  // allocate room for capacity names, kept for lifetime milliseconds
+  bool begin(uint8_t capacity, unsigned long lifetime);
+  void end();
+  bool enabled() { return _entries != NULL; }
+
+  bool lookup(const char* name, IPAddress& result);
+  void store(const char* name, IPAddress address);
+  void clear();
+
+  uint32_t hits() { return _hits; }
+  uint32_t misses() { return _misses; }
+
+private:
+  struct Entry {
+    char name[WIFI_DNS_CACHE_MAX_NAME];
+    uint32_t address;
+    unsigned long stored;
+    uint32_t used;
+  };
+
+  Entry* find(const char* name);
+
+  Entry* _entries;
+  uint8_t _capacity;
+  unsigned long _lifetime;
+  uint32_t _clock;
+  uint32_t _hits;
+  uint32_t _misses;
+};
+
+extern WiFiDnsCacheClass WiFiDnsCache;
+
+#endif
@@ -0,0 +1,137 @@
+/*
+  This file is part of the WiFiNINA library.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#include <string.h>
+
+#include "utility/wifi_drv.h"
+#include "utility/WiFiDnsCache.h"
+
+#include "WiFiResolver.h"
+
+WiFiResolverClass::WiFiResolverClass() :
+  _next(0)
+{
+  memset(&_slots, 0x00, sizeof(_slots));
+}
+
+int WiFiResolverClass::add(const char* name, WiFiResolveCallback callback)
+{
+  for (uint8_t i = 0; i < WIFI_RESOLVE_MAX_PENDING; i++) {
+    if (_slots[i].state == SLOT_FREE) {
+      _slots[i].name = name;
+      _slots[i].callback = callback;
+      _slots[i].address = 0;
+      _slots[i].state = SLOT_QUEUED;
+      return i + 1;
+    }
+  }
+  return 0;
+}
+
+int WiFiResolverClass::result(int handle, IPAddress& address)
+{
+  if (handle < 1 || handle > WIFI_RESOLVE_MAX_PENDING) {
+    return WIFI_RESOLVE_FAILED;
+  }
+
+  uint8_t index = handle - 1;
+
+  switch (_slots[index].state) {
+    case SLOT_DONE:
+      address = _slots[index].address;
+      _slots[index].state = SLOT_FREE;
+      return WIFI_RESOLVE_DONE;
+
+    case SLOT_QUEUED:
+      return WIFI_RESOLVE_PENDING;
+
+    default:
+      _slots[index].state = SLOT_FREE;
+      return WIFI_RESOLVE_FAILED;
+  }
+}
+
+void WiFiResolverClass::cancel(int handle)
+{
+  if (handle < 1 || handle > WIFI_RESOLVE_MAX_PENDING) {
+    return;
+  }
+
+  _slots[handle - 1].state = SLOT_FREE;
+}
+
+bool WiFiResolverClass::idle()
+{
+  for (uint8_t i = 0; i < WIFI_RESOLVE_MAX_PENDING; i++) {
+    if (_slots[i].state == SLOT_QUEUED) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void WiFiResolverClass::complete(uint8_t index, bool found)
+{
+  _slots[index].state = found ? SLOT_DONE : SLOT_FAILED;
+
+  if (_slots[index].callback) {
+    WiFiResolveCallback callback = _slots[index].callback;
+
+    // the slot is released before the call so the callback can queue again
+    _slots[index].state = SLOT_FREE;
+    callback(index + 1, _slots[index].name, found ? WIFI_RESOLVE_DONE : WIFI_RESOLVE_FAILED,
+             IPAddress(_slots[index].address));
+  }
+}
+
+void WiFiResolverClass::poll()
+{
+  // start the next queued name, in turn
+  for (uint8_t n = 0; n < WIFI_RESOLVE_MAX_PENDING; n++) {
+    uint8_t i = (_next + n) % WIFI_RESOLVE_MAX_PENDING;
+
+    if (_slots[i].state != SLOT_QUEUED) {
+      continue;
+    }
+
+    _next = (i + 1) % WIFI_RESOLVE_MAX_PENDING;
+
+    IPAddress address;
+    bool found;
+
+    if (WiFiDnsCache.enabled() && WiFiDnsCache.lookup(_slots[i].name, address)) {
+      found = true;
+    } else {
+      // the module keeps a single answer, any other lookup in between would
+      // replace it, so it is collected right after the request
+      found = WiFiDrv::reqHostByName(_slots[i].name) && (WiFiDrv::getHostByName(address) == 1);
+      if (found && WiFiDnsCache.enabled()) {
+        WiFiDnsCache.store(_slots[i].name, address);
+      }
+    }
+
+    if (found) {
+      _slots[i].address = address;
+    }
+    complete(i, found);
+    return;
+  }
+}
+
+WiFiResolverClass WiFiResolver;
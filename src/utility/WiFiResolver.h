@@ -0,0 +1,78 @@
+/*
+  This file is part of the WiFiNINA library.
+  Copyright (c) 2026 Arduino SA. All rights reserved.
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef WiFiResolver_h
+#define WiFiResolver_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "IPAddress.h"
+
+#ifdef __AVR__
+#define WIFI_RESOLVE_MAX_PENDING 4
+#else
+#define WIFI_RESOLVE_MAX_PENDING 8
+#endif
+
+enum {
+  WIFI_RESOLVE_FAILED = -1,
+  WIFI_RESOLVE_PENDING = 0,
+  WIFI_RESOLVE_DONE = 1
+};
+
+typedef void (*WiFiResolveCallback)(int handle, const char* name, int result, IPAddress address);
+
+class WiFiResolverClass {
+
+public:
+  WiFiResolverClass();
+
+  // queue name, which must stay valid until resolved, return a handle or 0 when full
+  int add(const char* name, WiFiResolveCallback callback);
+  // one of WIFI_RESOLVE_*, the handle is released once the result is returned
+  int result(int handle, IPAddress& address);
+  void cancel(int handle);
+  bool idle();
+
+  // resolve the next queued name, at most one per call
+  void poll();
+
+private:
+  enum {
+    SLOT_FREE,
+    SLOT_QUEUED,
+    SLOT_DONE,
+    SLOT_FAILED
+  };
+
+  void complete(uint8_t index, bool found);
+
+  struct {
+    const char* name;
+    WiFiResolveCallback callback;
+    uint32_t address;
+    uint8_t state;
+  } _slots[WIFI_RESOLVE_MAX_PENDING];
+  uint8_t _next;
+};
+
+extern WiFiResolverClass WiFiResolver;
+
+#endif
@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "Arduino.h"
+
 #include "utility/server_drv.h"
 
 #include "WiFiSocketBuffer.h"
@@ -51,6 +53,7 @@ void WiFiSocketBufferClass::close(int socket)
     _buffers[socket].data = _buffers[socket].head = NULL;
     _buffers[socket].length = 0;
   }
+  _buffers[socket].generation++;
 }
 
 int WiFiSocketBufferClass::available(int socket)
@@ -67,6 +70,7 @@ int WiFiSocketBufferClass::available(int socket)
     if (ServerDrv::getDataBuf(socket, _buffers[socket].data, &size)) {
       _buffers[socket].head = _buffers[socket].data;
       _buffers[socket].length = size;
+      _buffers[socket].lastActivity = millis();
     }
   }
 
@@ -101,4 +105,28 @@ int WiFiSocketBufferClass::read(int socket, uint8_t* data, size_t length)
   return length;
 }
 
+void WiFiSocketBufferClass::touch(int socket)
+{
+  _buffers[socket].lastActivity = millis();
+}
+
+int WiFiSocketBufferClass::view(int socket, const uint8_t** data)
+{
+  int avail = available(socket);
+
+  *data = _buffers[socket].head;
+
+  return avail;
+}
+
+void WiFiSocketBufferClass::skip(int socket, size_t length)
+{
+  if ((int)length > _buffers[socket].length) {
+    length = _buffers[socket].length;
+  }
+
+  _buffers[socket].head += length;
+  _buffers[socket].length -= length;
+}
+
 WiFiSocketBufferClass WiFiSocketBuffer;
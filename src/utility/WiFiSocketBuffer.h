@@ -39,11 +39,24 @@ public:
   int peek(int socket);
   int read(int socket, uint8_t* data, size_t length);
 
+  // direct access to the buffered data, valid until the next call for the socket
+  int view(int socket, const uint8_t** data);
+  void skip(int socket, size_t length);
+
+  // incremented every time the socket is closed, to detect reuse of its number
+  uint8_t generation(int socket) { return _buffers[socket].generation; }
+
+  // time in millis() of the last data received or sent on the socket
+  void touch(int socket);
+  unsigned long lastActivity(int socket) { return _buffers[socket].lastActivity; }
+
 private:
   struct {
     uint8_t* data;
     uint8_t* head;
     int length;
+    uint8_t generation;
+    unsigned long lastActivity;
   } _buffers[WIFI_MAX_SOCK_NUM];
 };
 
@@ -32,7 +32,7 @@ extern "C" {
 
 
 // Start server TCP on port specified
-void ServerDrv::startServer(uint16_t port, uint8_t sock, uint8_t protMode)
+bool ServerDrv::startServer(uint16_t port, uint8_t sock, uint8_t protMode)
 {
 	WAIT_FOR_SLAVE_SELECT();
     // Send Command
@@ -57,9 +57,10 @@ void ServerDrv::startServer(uint16_t port, uint8_t sock, uint8_t protMode)
         WARN("error waitResponse");
     }
     SpiDrv::spiSlaveDeselect();
+    return _data == 1;
 }
 
-void ServerDrv::startServer(uint32_t ipAddress, uint16_t port, uint8_t sock, uint8_t protMode)
+bool ServerDrv::startServer(uint32_t ipAddress, uint16_t port, uint8_t sock, uint8_t protMode)
 {
     WAIT_FOR_SLAVE_SELECT();
     // Send Command
@@ -82,6 +83,7 @@ void ServerDrv::startServer(uint32_t ipAddress, uint16_t port, uint8_t sock, uin
         WARN("error waitResponse");
     }
     SpiDrv::spiSlaveDeselect();
+    return _data == 1;
 }
 
 void ServerDrv::stopServer(uint8_t sock)
@@ -30,10 +30,10 @@ class ServerDrv
 {
 public:
 
-    // Start server TCP on port specified
-    static void startServer(uint16_t port, uint8_t sock, uint8_t protMode=TCP_MODE);
+    // Start server TCP on port specified, return true if the NINA bound the socket
+    static bool startServer(uint16_t port, uint8_t sock, uint8_t protMode=TCP_MODE);
 
-    static void startServer(uint32_t ipAddress, uint16_t port, uint8_t sock, uint8_t protMode=TCP_MODE);
+    static bool startServer(uint32_t ipAddress, uint16_t port, uint8_t sock, uint8_t protMode=TCP_MODE);
 
     static void stopServer(uint8_t sock);
 
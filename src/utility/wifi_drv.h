@@ -348,6 +348,7 @@ public:
 
     friend class WiFiUDP;
     friend class WiFiClient;
+    friend class WiFiResolverClass;
 };
 
 extern WiFiDrv wiFiDrv;
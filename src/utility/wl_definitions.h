@@ -38,7 +38,9 @@
 // Size of a MAC-address or BSSID
 #define WL_IPV4_LENGTH 4
 // Maximum size of a SSID list
+#ifndef WL_NETWORKS_LIST_MAXNUM
 #define WL_NETWORKS_LIST_MAXNUM	10
+#endif
 // Maximum number of socket
 #define	WIFI_MAX_SOCK_NUM	10
 // Socket not available constant